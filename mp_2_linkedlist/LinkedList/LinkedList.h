@@ -15,6 +15,43 @@
 #include <iostream> // for std::cerr, std::cout
 #include <ostream> // for std::ostream
 
+// Optional instrumentation mode: build with LINKEDLIST_INSTRUMENT defined,
+// for example "make CS400=-DLINKEDLIST_INSTRUMENT test", and every
+// LinkedList<T> will count its node allocations and frees, the number of
+// pointer hops taken while walking from node to node, and the peak number
+// of nodes alive at once. The counters are shared by all lists of the same
+// type T and can be read with LinkedList<T>::stats(). When the macro is not
+// defined, the counting statements below expand to nothing, so the normal
+// build pays no cost for them at all.
+// (All compilation units in a program must agree on this setting.)
+#ifdef LINKEDLIST_INSTRUMENT
+#define LINKEDLIST_NOTE_ALLOC() noteAlloc()
+#define LINKEDLIST_NOTE_FREE() noteFree()
+#define LINKEDLIST_NOTE_HOP() (stats().pointerHops++)
+#else
+#define LINKEDLIST_NOTE_ALLOC() ((void)0)
+#define LINKEDLIST_NOTE_FREE() ((void)0)
+#define LINKEDLIST_NOTE_HOP() ((void)0)
+#endif
+
+// Counters reported by LinkedList<T>::stats(). These stay at zero unless
+// LINKEDLIST_INSTRUMENT is defined.
+struct LinkedListStats {
+  // Number of nodes created with "new".
+  long long nodeAllocs;
+  // Number of nodes destroyed with "delete".
+  long long nodeFrees;
+  // Number of times a traversal followed a next or prev pointer.
+  long long pointerHops;
+  // Number of nodes currently alive.
+  long long liveNodes;
+  // The highest value liveNodes has reached since the last reset.
+  long long peakNodes;
+
+  LinkedListStats() : nodeAllocs(0), nodeFrees(0), pointerHops(0),
+    liveNodes(0), peakNodes(0) {}
+};
+
 // LinkedList class: A doubly-linked list. It can be used similarly
 // to a double-ended queue or a stack. The nodes are created on the heap
 // and connected in a chain by next and prev pointers. The nodes contain
@@ -273,6 +310,7 @@ public:
       pushBack(cur->data);
       // Iterate
       cur = cur->next;
+      LINKEDLIST_NOTE_HOP();
     }
 
     return *this;
@@ -299,6 +337,41 @@ public:
   // this throws an exception. This is for testing only.
   bool assertPrevLinks() const;
 
+  // Instrumentation counters shared by all lists of type LinkedList<T>.
+  // (See the note about LINKEDLIST_INSTRUMENT at the top of this file.)
+  // The function-local static avoids needing a separate definition line.
+  static LinkedListStats& stats() {
+    static LinkedListStats counters;
+    return counters;
+  }
+
+  // Reset the counters before measuring an operation. The nodes that are
+  // still alive remain counted, so liveNodes is kept and the peak restarts
+  // from the current number of live nodes.
+  static void resetStats() {
+    LinkedListStats& s = stats();
+    long long live = s.liveNodes;
+    s = LinkedListStats();
+    s.liveNodes = live;
+    s.peakNodes = live;
+  }
+
+private:
+
+  // Helpers for the LINKEDLIST_NOTE_ALLOC and LINKEDLIST_NOTE_FREE macros.
+  static void noteAlloc() {
+    LinkedListStats& s = stats();
+    s.nodeAllocs++;
+    s.liveNodes++;
+    if (s.liveNodes > s.peakNodes) s.peakNodes = s.liveNodes;
+  }
+
+  static void noteFree() {
+    LinkedListStats& s = stats();
+    s.nodeFrees++;
+    s.liveNodes--;
+  }
+
 };
 
 // =======================================================================
@@ -384,6 +457,7 @@ void LinkedList<T>::pushFront(const T& newData) {
 
   // allocate a new node
   Node* newNode = new Node(newData);
+  LINKEDLIST_NOTE_ALLOC();
 
   if (!head_) {
     // If empty, insert as the only item as both head and tail.
@@ -411,6 +485,7 @@ void LinkedList<T>::pushBack(const T& newData) {
 
   // allocate a new node
   Node* newNode = new Node(newData);
+  LINKEDLIST_NOTE_ALLOC();
 
   if (!head_) {
     // If empty, insert as the only item as both head and tail.
@@ -444,6 +519,7 @@ void LinkedList<T>::popFront() {
   if (!head_->next) {
     // deallocate the only item
     delete head_;
+    LINKEDLIST_NOTE_FREE();
     // reset list pointers
     head_ = nullptr;
     tail_ = nullptr;
@@ -460,10 +536,12 @@ void LinkedList<T>::popFront() {
   Node* oldHead = head_;
   // Update head_ to point to the following item.
   head_ = head_->next;
+  LINKEDLIST_NOTE_HOP();
   // Now set the new head_'s previous pointer to null.
   head_->prev = nullptr;
   // Deallocate the old head_ item
   delete oldHead;
+  LINKEDLIST_NOTE_FREE();
   // It's a good practice to set pointers to null after you delete them for safety,
   // even if you don't think you're going to dereference the same pointer again.
   oldHead = nullptr;
@@ -484,6 +562,7 @@ void LinkedList<T>::popBack() {
   if (!tail_->prev) {
     // deallocate the only item
     delete tail_;
+    LINKEDLIST_NOTE_FREE();
     // reset list pointers
     head_ = nullptr;
     tail_ = nullptr;
@@ -500,10 +579,12 @@ void LinkedList<T>::popBack() {
   Node* oldTail = tail_;
   // Update tail_ to point to the preceding item
   tail_ = tail_->prev;
+  LINKEDLIST_NOTE_HOP();
   // Now set the new tail_'s next pointer to null.
   tail_->next = nullptr;
   // Deallocate the old tail_ item
   delete oldTail;
+  LINKEDLIST_NOTE_FREE();
   // It's a good practice to set pointers to null after you delete them for safety,
   // even if you don't think you're going to dereference the same pointer again.
   oldTail = nullptr;
@@ -531,6 +612,7 @@ bool LinkedList<T>::isSorted() const {
     // Step forward
     prev = cur;
     cur = cur->next;
+    LINKEDLIST_NOTE_HOP();
     if (!(prev->data <= cur->data)) {
       // Previous data was not <= current data, so return false.
       return false;
@@ -566,6 +648,8 @@ bool LinkedList<T>::equals(const LinkedList<T>& other) const {
     }
     thisCur = thisCur->next;
     otherCur = otherCur->next;
+    LINKEDLIST_NOTE_HOP();
+    LINKEDLIST_NOTE_HOP();
   }
 
   return true;
@@ -586,6 +670,7 @@ LinkedList<T> LinkedList<T>::insertionSort() const {
   while (cur) {
     result.insertOrdered(cur->data); //O(n) for each insertOrdered, need to check value on each position to insert
     cur = cur->next;
+    LINKEDLIST_NOTE_HOP();
   }
 
   return result;
@@ -624,6 +709,7 @@ std::ostream& LinkedList<T>::print(std::ostream& os) const {
   while (cur) {
     os << "(" << cur->data << ")";
     cur = cur->next;
+    LINKEDLIST_NOTE_HOP();
   }
 
   os << "]";
@@ -858,6 +944,7 @@ bool LinkedList<T>::assertCorrectSize() const {
   while (cur) {
     itemCount++;
     cur = cur->next;
+    LINKEDLIST_NOTE_HOP();
   }
   if (itemCount != size_) throw std::runtime_error(std::string("Error in assertCorrectSize: ") + LIST_GENERAL_BUG_MESSAGE);
   else return true;
@@ -128,6 +128,7 @@ void LinkedList<T>::insertOrdered(const T& newData) {
   // to update all next, prev, head_, and tail_ pointers as needed on your
   // new node or on those existing nodes that are adjacent to the new node.
   Node* newnode = new Node(newData);
+  LINKEDLIST_NOTE_ALLOC();
   if(!head_) { //base case, no node
     head_ = newnode;
     tail_ = newnode;
@@ -140,6 +141,7 @@ void LinkedList<T>::insertOrdered(const T& newData) {
     prev = curr;
     if(curr->next) curr = curr->next;
     else curr = NULL;
+    LINKEDLIST_NOTE_HOP();
   }
   if(!prev) { //adding to head
     newnode->next = head_;
@@ -280,15 +282,19 @@ LinkedList<T> LinkedList<T>::merge(const LinkedList<T>& other) const {
     if(leftcurr && rightcurr && leftcurr->data < rightcurr->data) {
       merged.pushBack(leftcurr->data);
       leftcurr = leftcurr->next;
+      LINKEDLIST_NOTE_HOP();
     } else if(leftcurr && rightcurr) {
       merged.pushBack(rightcurr->data);
       rightcurr = rightcurr->next;
+      LINKEDLIST_NOTE_HOP();
     } else if(leftcurr) {
       merged.pushBack(leftcurr->data);
       leftcurr = leftcurr -> next;
+      LINKEDLIST_NOTE_HOP();
     } else {
       merged.pushBack(rightcurr->data);
       rightcurr = rightcurr->next;
+      LINKEDLIST_NOTE_HOP();
     }
   } 
 
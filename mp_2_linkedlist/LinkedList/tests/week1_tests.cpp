@@ -695,3 +695,50 @@ TEST_CASE("Testing merge: Left and right lists non-empty; right list is longer",
   }
 }
 
+
+// ========================================================================
+// Tests: instrumentation counters
+// ========================================================================
+
+// The counters are only collected when building with LINKEDLIST_INSTRUMENT,
+// e.g.: make clean && make CS400=-DLINKEDLIST_INSTRUMENT test && ./test
+TEST_CASE("Testing instrumentation: allocations, frees, hops, and peak", "[weight=0]") {
+
+  // Use a type that no other test touches so the shared counters start clean.
+  using Counted = long;
+  LinkedList<Counted>::resetStats();
+
+  {
+    LinkedList<Counted> l;
+    l.pushBack(1);
+    l.pushBack(3);
+    l.pushFront(0);
+    l.insertOrdered(2);
+    REQUIRE(l.assertCorrectSize());
+  }
+
+  const LinkedListStats& stats = LinkedList<Counted>::stats();
+
+#ifdef LINKEDLIST_INSTRUMENT
+  SECTION("Checking that every allocated node was freed") {
+    REQUIRE(stats.nodeAllocs == 4);
+    REQUIRE(stats.nodeFrees == 4);
+    REQUIRE(stats.liveNodes == 0);
+  }
+
+  SECTION("Checking the peak node count") {
+    REQUIRE(stats.peakNodes == 4);
+  }
+
+  SECTION("Checking that traversals were counted") {
+    REQUIRE(stats.pointerHops > 0);
+  }
+#else
+  SECTION("Checking that the counters stay at zero when disabled") {
+    REQUIRE(stats.nodeAllocs == 0);
+    REQUIRE(stats.nodeFrees == 0);
+    REQUIRE(stats.pointerHops == 0);
+    REQUIRE(stats.peakNodes == 0);
+  }
+#endif
+}
@@ -0,0 +1,294 @@
+/**
+ * @file FlatGenericTree.h
+ * University of Illinois CS 400, MOOC 2, Week 3: Generic Tree
+ *
+ * A contiguous-storage alternative to GenericTree<T>.
+ *
+**/
+
+#pragma once
+
+#include <cstdint> // for std::uint32_t
+#include <stdexcept> // for std::runtime_error
+#include <vector> // for std::vector
+
+#include "GenericTree.h"
+
+// -------------------------------------------------------------------
+// FlatGenericTree<T> class
+// -------------------------------------------------------------------
+// This stores the same kind of N-ary tree as GenericTree<T>, but instead
+// of allocating every node separately on the heap with its own std::vector
+// of children pointers, all of the nodes live together in one std::vector.
+// Nodes refer to each other by their index in that vector rather than by
+// pointer, using a "first child, next sibling" representation: each node
+// knows its leftmost child, and each child knows the sibling to its right.
+// (We also remember the rightmost child so that adding a child stays O(1).)
+//
+// Adding a child just appends one element to the vector, so most calls to
+// addChild don't allocate at all, and nodes that are visited together are
+// usually close together in memory.
+//
+// When nodes are stored in level order (which is the case for a tree that
+// was built breadth-first, or after calling relayoutLevelOrder()), the
+// children of every node form a contiguous range of indices and a level-order
+// traversal is just a linear scan of the vector. The class keeps track of
+// whether that is still true as children are added.
+
+template <typename T>
+class FlatGenericTree {
+public:
+
+  // Nodes are identified by their position in the node vector. 32-bit
+  // indices are half the size of pointers on a 64-bit machine, which
+  // matters when a tree has many millions of nodes.
+  using NodeIndex = std::uint32_t;
+
+  // Index value that means "no node", similar to nullptr for GenericTree.
+  static constexpr NodeIndex NO_NODE = 0xFFFFFFFFu;
+
+  // An internal class type for tree nodes.
+  class FlatNode {
+  public:
+    // Index of the node's parent (NO_NODE for the root)
+    NodeIndex parentIndex;
+    // Index of the leftmost child (NO_NODE if there are no children)
+    NodeIndex firstChildIndex;
+    // Index of the rightmost child (NO_NODE if there are no children)
+    NodeIndex lastChildIndex;
+    // Index of the next sibling to the right (NO_NODE for the rightmost child)
+    NodeIndex nextSiblingIndex;
+    // The actual node data, stored by value.
+    T data;
+
+    FlatNode(const T& dataArg, NodeIndex parentArg) : parentIndex(parentArg),
+      firstChildIndex(NO_NODE), lastChildIndex(NO_NODE),
+      nextSiblingIndex(NO_NODE), data(dataArg) {}
+  };
+
+private:
+  // All nodes of the tree. The root, if any, is always at index 0.
+  std::vector<FlatNode> nodes_;
+
+  // True while nodes_ is in level order (breadth-first, left to right).
+  bool levelOrdered_;
+
+public:
+
+  // Default constructor: The tree will be empty.
+  FlatGenericTree() : levelOrdered_(true) {}
+
+  // Build a flat copy of a pointer-based GenericTree. The nodes are laid
+  // out in level order, and null children pointers are skipped.
+  template <typename Aggregate>
+  explicit FlatGenericTree(GenericTree<T, Aggregate>& tree);
+
+  // Create the root node (which must not already exist).
+  // Returns the index of the root node, which is always 0.
+  NodeIndex createRoot(const T& rootData);
+
+  // Add a rightmost child storing a copy of the data to the node at the
+  // given parent index. Returns the index of the new child.
+  // (Since adding a node may reallocate the vector, references to nodes
+  //  or data are invalidated by addChild, but indices stay valid.)
+  NodeIndex addChild(NodeIndex parentIndex, const T& childData);
+
+  // Index of the root node, or NO_NODE if the tree is empty.
+  NodeIndex getRootIndex() const {
+    return nodes_.empty() ? NO_NODE : 0;
+  }
+
+  // Access a node by index. An out-of-range index throws std::out_of_range.
+  FlatNode& node(NodeIndex index) { return nodes_.at(index); }
+  const FlatNode& node(NodeIndex index) const { return nodes_.at(index); }
+
+  // Read-only access to the underlying node storage, in storage order.
+  const std::vector<FlatNode>& nodes() const { return nodes_; }
+
+  // Number of nodes in the tree.
+  std::size_t size() const { return nodes_.size(); }
+
+  // Returns true if the tree has no nodes.
+  bool empty() const { return nodes_.empty(); }
+
+  // Pre-allocate room for the given number of nodes, so that building a
+  // tree of known size doesn't have to regrow the vector.
+  void reserve(std::size_t nodeCount) { nodes_.reserve(nodeCount); }
+
+  // Remove all nodes. This is a single deallocation, not one per node.
+  void clear() {
+    nodes_.clear();
+    levelOrdered_ = true;
+  }
+
+  // Returns true if the nodes are currently stored in level order, so that
+  // a level-order traversal is the same as reading the nodes in storage order.
+  bool isLevelOrdered() const { return levelOrdered_; }
+
+  // Rearrange the node storage into level order. This runs in O(n) time
+  // and renumbers the nodes, so previously saved indices become invalid.
+  void relayoutLevelOrder();
+
+};
+
+// In some versions of C++ we have to redeclare a constant static member
+// at global scope like this to ensure that the linker doesn't give an error.
+template <typename T>
+constexpr typename FlatGenericTree<T>::NodeIndex FlatGenericTree<T>::NO_NODE;
+
+// =======================================================================
+//   Implementation section
+// =======================================================================
+
+template <typename T>
+template <typename Aggregate>
+FlatGenericTree<T>::FlatGenericTree(GenericTree<T, Aggregate>& tree) : FlatGenericTree() {
+
+  using TreeNode = typename GenericTree<T, Aggregate>::TreeNode;
+
+  TreeNode* rootNodePtr = tree.getRootPtr();
+  if (!rootNodePtr) return;
+
+  // We record which original node each flat node was copied from. Because
+  // we append children in the order we scan the flat nodes, the flat vector
+  // itself acts as the queue for a breadth-first traversal.
+  std::vector<const TreeNode*> sources;
+  sources.push_back(rootNodePtr);
+  createRoot(rootNodePtr->data);
+
+  for (std::size_t i = 0; i < sources.size(); i++) {
+    for (const TreeNode* childPtr : sources[i]->childrenPtrs) {
+      if (childPtr) {
+        addChild(static_cast<NodeIndex>(i), childPtr->data);
+        sources.push_back(childPtr);
+      }
+    }
+  }
+}
+
+template <typename T>
+typename FlatGenericTree<T>::NodeIndex FlatGenericTree<T>::createRoot(const T& rootData) {
+  if (!nodes_.empty()) {
+    constexpr char ERROR_MESSAGE[] = "Tried to createRoot when root already exists";
+    std::cerr << ERROR_MESSAGE << std::endl;
+    throw std::runtime_error(ERROR_MESSAGE);
+  }
+
+  nodes_.emplace_back(rootData, NO_NODE);
+  levelOrdered_ = true;
+  return 0;
+}
+
+template <typename T>
+typename FlatGenericTree<T>::NodeIndex FlatGenericTree<T>::addChild(NodeIndex parentIndex, const T& childData) {
+  if (parentIndex >= nodes_.size()) {
+    throw std::runtime_error("Tried to addChild to a node that does not exist");
+  }
+  if (nodes_.size() >= NO_NODE) {
+    throw std::runtime_error("FlatGenericTree node index space is exhausted");
+  }
+
+  NodeIndex newIndex = static_cast<NodeIndex>(nodes_.size());
+
+  // Level order is the same as sorting the nodes by their parent's position
+  // (siblings keep their left-to-right order). So the storage stays in level
+  // order as long as the new node's parent doesn't come before the parent of
+  // the node that is currently stored last.
+  NodeIndex lastParentIndex = nodes_.back().parentIndex;
+  if (NO_NODE != lastParentIndex && parentIndex < lastParentIndex) {
+    levelOrdered_ = false;
+  }
+
+  // Note that emplace_back may reallocate, so we look up the parent afterward.
+  nodes_.emplace_back(childData, parentIndex);
+
+  FlatNode& parent = nodes_[parentIndex];
+  if (NO_NODE == parent.lastChildIndex) {
+    parent.firstChildIndex = newIndex;
+  }
+  else {
+    nodes_[parent.lastChildIndex].nextSiblingIndex = newIndex;
+  }
+  parent.lastChildIndex = newIndex;
+
+  return newIndex;
+}
+
+template <typename T>
+void FlatGenericTree<T>::relayoutLevelOrder() {
+  if (levelOrdered_) return;
+
+  // As in the converting constructor, the new vector serves as its own
+  // breadth-first queue. oldIndices[i] is where new node i used to be.
+  std::vector<FlatNode> reordered;
+  reordered.reserve(nodes_.size());
+  std::vector<NodeIndex> oldIndices;
+  oldIndices.reserve(nodes_.size());
+
+  reordered.emplace_back(nodes_[0].data, NO_NODE);
+  oldIndices.push_back(0);
+
+  for (std::size_t i = 0; i < reordered.size(); i++) {
+    NodeIndex newParentIndex = static_cast<NodeIndex>(i);
+    NodeIndex oldChild = nodes_[oldIndices[i]].firstChildIndex;
+    while (NO_NODE != oldChild) {
+      NodeIndex newIndex = static_cast<NodeIndex>(reordered.size());
+      reordered.emplace_back(nodes_[oldChild].data, newParentIndex);
+      oldIndices.push_back(oldChild);
+
+      FlatNode& parent = reordered[newParentIndex];
+      if (NO_NODE == parent.lastChildIndex) {
+        parent.firstChildIndex = newIndex;
+      }
+      else {
+        reordered[parent.lastChildIndex].nextSiblingIndex = newIndex;
+      }
+      parent.lastChildIndex = newIndex;
+
+      oldChild = nodes_[oldChild].nextSiblingIndex;
+    }
+  }
+
+  nodes_.swap(reordered);
+  levelOrdered_ = true;
+}
+
+// Level-order traversal of a FlatGenericTree, with the same results as
+// traverseLevels for a GenericTree with the same shape and data.
+// When the storage is already in level order this is a single linear pass
+// over the node vector; otherwise it's a breadth-first search over indices.
+template <typename T>
+std::vector<T> traverseLevels(const FlatGenericTree<T>& tree) {
+
+  using NodeIndex = typename FlatGenericTree<T>::NodeIndex;
+  constexpr NodeIndex NO_NODE = FlatGenericTree<T>::NO_NODE;
+
+  std::vector<T> results;
+  results.reserve(tree.size());
+
+  const auto& nodes = tree.nodes();
+
+  if (tree.isLevelOrdered()) {
+    for (const auto& node : nodes) {
+      results.push_back(node.data);
+    }
+    return results;
+  }
+
+  // Use a vector with a moving front index as the queue; it never needs to
+  // hold more than the n node indices.
+  std::vector<NodeIndex> queue;
+  queue.reserve(tree.size());
+  if (!nodes.empty()) queue.push_back(0);
+
+  for (std::size_t front = 0; front < queue.size(); front++) {
+    const auto& node = nodes[queue[front]];
+    results.push_back(node.data);
+    for (NodeIndex child = node.firstChildIndex; NO_NODE != child; child = nodes[child].nextSiblingIndex) {
+      queue.push_back(child);
+    }
+  }
+
+  return results;
+}
+
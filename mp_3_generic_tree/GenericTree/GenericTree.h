@@ -11,12 +11,22 @@
 // be included multiple times per compilation unit by mistake.
 #pragma once
 
+#include <cstdint> // for std::uintptr_t
 #include <stdexcept> // for std::runtime_error
 #include <stack> // for std::stack
 #include <queue> // for std::queue
 #include <vector> // for std::vector
+#include <algorithm> // for std::remove
+#include <atomic> // for std::atomic
+#include <thread> // for std::thread
+#include <memory> // for std::unique_ptr
+#include <new> // for placement new
+#include <type_traits> // for std::true_type, std::is_trivially_destructible
+#include <utility> // for std::declval
 #include <iostream> // for std::cerr, std::cout
 #include <ostream> // for std::ostream
+#include <streambuf> // for std::streambuf
+#include <string> // for std::string
 
 // -------------------------------------------------------------------
 // GenericTree<T> class
@@ -33,8 +43,233 @@
 // to make edits in GenericTreeExercises.h. However, you are welcome
 // to study this file for insight about how the class works, as well as
 // tips on how to approach the exercises in the assignment.
+//
+// The optional second template argument selects a cached subtree
+// aggregate (see "Subtree aggregates" below). By default there is none.
 
-template <typename T>
+// -------------------------------------------------------------------
+// Subtree aggregates
+// -------------------------------------------------------------------
+// Functions like countNullChildrenIterative have to visit every node of
+// a subtree each time they are called. Instead, a GenericTree can keep a
+// summary value of every subtree (such as the number of nodes in it)
+// stored in each node, and update those values as the tree changes.
+// Then the summary for the whole tree, or for any subtree, is just a
+// lookup of the "aggregate" member of a node.
+//
+// An aggregate policy is a struct with these static members:
+//   value_type             - the type of the summary value
+//   ofNode(const T& data)  - the value contributed by a node's own data
+//   ofNull()               - the value contributed by a null child pointer
+//   combine(a, b)          - combines two values; this must be associative
+// A node's aggregate is its ofNode value combined with the aggregates of
+// its children from left to right (with ofNull for null children).
+//
+// If the policy also has a member subtract(a, b) that undoes combine
+// (so that combine is like addition and subtract is like subtraction),
+// and combine is commutative, then each change only has to adjust the
+// values of the ancestors of the changed node: O(depth). Otherwise, each
+// ancestor is recomputed from its children: O(depth * number of children).
+//
+// The aggregates are updated automatically by addChild, deleteSubtree, and
+// compress. If you edit a node's data or childrenPtrs directly, call
+// refreshAggregates() on the tree afterward.
+
+// The default policy: no aggregate is stored, and nothing is maintained.
+struct NoAggregate {
+  using value_type = void;
+};
+
+// Number of nodes in each subtree.
+struct SubtreeSizeAggregate {
+  using value_type = int;
+  template <typename T>
+  static int ofNode(const T& data) { return 1; }
+  static int ofNull() { return 0; }
+  static int combine(int a, int b) { return a + b; }
+  static int subtract(int a, int b) { return a - b; }
+};
+
+// Number of null children pointers in each subtree, which is the same
+// as what countNullChildrenRecursive and countNullChildrenIterative count.
+struct NullChildCountAggregate {
+  using value_type = int;
+  template <typename T>
+  static int ofNode(const T& data) { return 0; }
+  static int ofNull() { return 1; }
+  static int combine(int a, int b) { return a + b; }
+  static int subtract(int a, int b) { return a - b; }
+};
+
+// Storage for the aggregate value in each node. This is a base class of
+// the tree node type, and it's empty for NoAggregate.
+template <typename Aggregate>
+class AggregateSlot {
+public:
+  typename Aggregate::value_type aggregate;
+};
+
+template <>
+class AggregateSlot<NoAggregate> {};
+
+// Detects whether an aggregate policy has a subtract member.
+template <typename Aggregate, typename = void>
+struct IsInvertibleAggregate : std::false_type {};
+
+template <typename Aggregate>
+struct IsInvertibleAggregate<Aggregate, decltype((void)Aggregate::subtract(
+  std::declval<typename Aggregate::value_type>(), std::declval<typename Aggregate::value_type>()))>
+  : std::true_type {};
+
+// The static functions that GenericTree calls to keep aggregates current.
+template <typename Aggregate>
+struct AggregateMaintenance {
+  using Value = typename Aggregate::value_type;
+
+  // Set a new node's aggregate from its own data (it has no children yet).
+  template <typename Node>
+  static void initLeaf(Node* node) {
+    node->aggregate = Aggregate::ofNode(node->data);
+  }
+
+  // Compute a node's aggregate from its data and its children's aggregates.
+  template <typename Node>
+  static void recompute(Node* node) {
+    Value value = Aggregate::ofNode(node->data);
+    for (const Node* childPtr : node->childrenPtrs) {
+      value = Aggregate::combine(value, childPtr ? childPtr->aggregate : Aggregate::ofNull());
+    }
+    node->aggregate = value;
+  }
+
+  // A new rightmost child was added to parent. Update parent and all of
+  // its ancestors.
+  template <typename Node>
+  static void childAdded(Node* parent, const Node* child) {
+    addToAncestors(parent, child->aggregate, IsInvertibleAggregate<Aggregate>());
+  }
+
+  // One of parent's children pointers to child was replaced by nullptr.
+  // Update parent and all of its ancestors.
+  template <typename Node>
+  static void childRemoved(Node* parent, const Node* child) {
+    updateAncestors(parent, child->aggregate, Aggregate::ofNull(), IsInvertibleAggregate<Aggregate>());
+  }
+
+  // Recompute every aggregate in the subtree, children before parents.
+  template <typename Node>
+  static void recomputeSubtree(Node* subtreeRoot) {
+    if (!subtreeRoot) return;
+    std::vector<Node*> preOrderNodes;
+    std::vector<Node*> nodesToExplore(1, subtreeRoot);
+    while (!nodesToExplore.empty()) {
+      Node* curNode = nodesToExplore.back();
+      nodesToExplore.pop_back();
+      preOrderNodes.push_back(curNode);
+      for (Node* childPtr : curNode->childrenPtrs) {
+        if (childPtr) nodesToExplore.push_back(childPtr);
+      }
+    }
+    // In reverse pre-order, every node comes after all of its descendants.
+    for (auto it = preOrderNodes.rbegin(); it != preOrderNodes.rend(); it++) {
+      recompute(*it);
+    }
+  }
+
+private:
+  template <typename Node>
+  static void updateAncestors(Node* node, const Value& oldValue, const Value& newValue, std::true_type) {
+    for (; node; node = node->parentPtr) {
+      node->aggregate = Aggregate::combine(Aggregate::subtract(node->aggregate, oldValue), newValue);
+    }
+  }
+
+  template <typename Node>
+  static void updateAncestors(Node* node, const Value& oldValue, const Value& newValue, std::false_type) {
+    for (; node; node = node->parentPtr) {
+      recompute(node);
+    }
+  }
+
+  template <typename Node>
+  static void addToAncestors(Node* node, const Value& newValue, std::true_type) {
+    for (; node; node = node->parentPtr) {
+      node->aggregate = Aggregate::combine(node->aggregate, newValue);
+    }
+  }
+
+  template <typename Node>
+  static void addToAncestors(Node* node, const Value& newValue, std::false_type) {
+    // The new child is rightmost, so the parent can just combine it on the
+    // right, but the other ancestors need to be recomputed.
+    node->aggregate = Aggregate::combine(node->aggregate, newValue);
+    for (node = node->parentPtr; node; node = node->parentPtr) {
+      recompute(node);
+    }
+  }
+};
+
+// With NoAggregate, all of the maintenance compiles away to nothing.
+template <>
+struct AggregateMaintenance<NoAggregate> {
+  template <typename Node>
+  static void initLeaf(Node* node) {}
+  template <typename Node>
+  static void recompute(Node* node) {}
+  template <typename Node>
+  static void childAdded(Node* parent, const Node* child) {}
+  template <typename Node>
+  static void childRemoved(Node* parent, const Node* child) {}
+  template <typename Node>
+  static void recomputeSubtree(Node* subtreeRoot) {}
+};
+
+// -------------------------------------------------------------------
+// TreePrintBuffer class
+// -------------------------------------------------------------------
+// A stream buffer used by GenericTree::Print. Characters are collected in a
+// large array and written to the target stream one block at a time, which
+// is much faster than sending each small piece of output separately.
+
+class TreePrintBuffer : public std::streambuf {
+public:
+  explicit TreePrintBuffer(std::ostream& targetArg, std::size_t bufferSize = 64 * 1024)
+    : target(targetArg), buffer(bufferSize) {
+    setp(buffer.data(), buffer.data() + buffer.size());
+  }
+
+  // Disable copying, since the put area points into our own buffer.
+  TreePrintBuffer(const TreePrintBuffer& other) = delete;
+  TreePrintBuffer& operator=(const TreePrintBuffer& other) = delete;
+
+protected:
+  // Called when the buffer is full: write it out and start over.
+  int_type overflow(int_type ch) override {
+    writeBuffer();
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+    }
+    return traits_type::not_eof(ch);
+  }
+
+  // Called when the stream is flushed.
+  int sync() override {
+    writeBuffer();
+    return target ? 0 : -1;
+  }
+
+private:
+  std::ostream& target;
+  std::vector<char> buffer;
+
+  void writeBuffer() {
+    target.write(pbase(), pptr() - pbase());
+    setp(buffer.data(), buffer.data() + buffer.size());
+  }
+};
+
+template <typename T, typename Aggregate = NoAggregate>
 class GenericTree {
 public:
 
@@ -42,8 +277,70 @@ public:
   // We'll set it to false by default.
   bool showDebugMessages;
 
+  // How the nodes of a tree get their memory:
+  // Heap: Every node is allocated separately with "new" and freed with
+  //   "delete" (the default).
+  // Arena: All nodes, and the children pointer arrays inside them, are
+  //   carved out of large blocks that belong to the tree (see NodeArena).
+  //   Creating a node just bumps a position within the current block.
+  //   Deleting a subtree only unlinks it; its memory is reclaimed all at
+  //   once when the whole tree is cleared or destroyed.
+  enum class Allocation { Heap, Arena };
+
+  class TreeNode;
+  class NodeArena;
+
+  // Allocator used for each node's childrenPtrs vector. It remembers the
+  // arena of the tree that the node belongs to, or nullptr for a tree that
+  // uses the ordinary heap. (The STL containers accept a custom allocator
+  // type like this as an optional template argument.)
+  template <typename U>
+  class ArenaAllocator {
+  public:
+    using value_type = U;
+    // When vectors are swapped or assigned, the allocator goes along with
+    // the memory it allocated.
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    template <typename V>
+    struct rebind { using other = ArenaAllocator<V>; };
+
+    NodeArena* arenaPtr;
+
+    ArenaAllocator() noexcept : arenaPtr(nullptr) {}
+    explicit ArenaAllocator(NodeArena* arenaArg) noexcept : arenaPtr(arenaArg) {}
+    template <typename V>
+    ArenaAllocator(const ArenaAllocator<V>& other) noexcept : arenaPtr(other.arenaPtr) {}
+
+    U* allocate(std::size_t count) {
+      if (arenaPtr) {
+        return static_cast<U*>(arenaPtr->allocateBytes(count * sizeof(U), alignof(U)));
+      }
+      return static_cast<U*>(::operator new(count * sizeof(U)));
+    }
+
+    // Memory from the arena is only released together with the whole arena.
+    void deallocate(U* ptr, std::size_t count) noexcept {
+      if (!arenaPtr) {
+        ::operator delete(ptr);
+      }
+    }
+
+    template <typename V>
+    bool operator==(const ArenaAllocator<V>& other) const noexcept { return arenaPtr == other.arenaPtr; }
+    template <typename V>
+    bool operator!=(const ArenaAllocator<V>& other) const noexcept { return arenaPtr != other.arenaPtr; }
+  };
+
+  // The type of the childrenPtrs vector in each node.
+  using ChildrenPtrVector = std::vector< TreeNode*, ArenaAllocator<TreeNode*> >;
+
   // An internal class type for tree nodes.
-  class TreeNode {
+  // (When an aggregate policy is used, the node also has an "aggregate"
+  //  member holding the cached value for its subtree; see above.)
+  class TreeNode : public AggregateSlot<Aggregate> {
   public:
     // Pointer to the node's parent (nullptr if there is no parent)
     TreeNode* parentPtr;
@@ -54,7 +351,9 @@ public:
     // such as std::list or std::set. There are various advantages to
     // different strategies, depending on how you design the tree class
     // functions.
-    std::vector< TreeNode* > childrenPtrs;
+    // (For a tree in the Arena allocation mode, the vector's storage comes
+    //  from the tree's arena. Otherwise it behaves like std::vector<TreeNode*>.)
+    ChildrenPtrVector childrenPtrs;
     
     // The actual node data. It's an actual copy of the node's data,
     // not just a pointer or reference. This is slightly different
@@ -66,11 +365,21 @@ public:
     TreeNode* addChild(const T& childData);
 
     // Default constructor: Indicate that there is no parent.
-    TreeNode() : parentPtr(nullptr) {}
+    TreeNode() : parentPtr(nullptr) {
+      AggregateMaintenance<Aggregate>::initLeaf(this);
+    }
 
     // Constructor based on data argument:
     // Specifies no parent, but does copy in the data member by value.
-    TreeNode(const T& dataArg) : parentPtr(nullptr), data(dataArg) {}
+    TreeNode(const T& dataArg) : parentPtr(nullptr), data(dataArg) {
+      AggregateMaintenance<Aggregate>::initLeaf(this);
+    }
+
+    // Constructor for a node whose children vector uses a specific allocator.
+    TreeNode(const T& dataArg, const ArenaAllocator<TreeNode*>& allocatorArg) :
+      parentPtr(nullptr), childrenPtrs(allocatorArg), data(dataArg) {
+      AggregateMaintenance<Aggregate>::initLeaf(this);
+    }
 
     // There is a special syntax for disabling certain constructors entirely.
     // This inhibits default versions from being generated by the compiler.
@@ -94,11 +403,122 @@ public:
 
   };
 
+  // NodeArena: A simple monotonic memory region owned by one tree.
+  // Nodes are constructed in fixed-size blocks, one after another, and
+  // other memory (for the children vectors) is handed out from larger
+  // chunks of raw bytes. Nothing is freed individually; release() frees
+  // everything at once. Because every node ever created lives in one of
+  // the node blocks, release() can find them all with a linear sweep
+  // instead of walking the tree.
+  class NodeArena {
+  public:
+    NodeArena() : nodesInLastBlock_(NODES_PER_BLOCK), bytePos_(nullptr), byteEnd_(nullptr) {}
+
+    NodeArena(const NodeArena& other) = delete;
+    NodeArena& operator=(const NodeArena& other) = delete;
+
+    ~NodeArena() {
+      release();
+    }
+
+    // Construct a new node in the next free slot of the current block.
+    TreeNode* createNode(const T& dataArg) {
+      if (NODES_PER_BLOCK == nodesInLastBlock_) {
+        reserveOneMore(nodeBlocks_);
+        nodeBlocks_.push_back(static_cast<TreeNode*>(::operator new(NODES_PER_BLOCK * sizeof(TreeNode))));
+        nodesInLastBlock_ = 0;
+      }
+      TreeNode* slot = nodeBlocks_.back() + nodesInLastBlock_;
+      // If the constructor throws, the slot simply stays unused.
+      TreeNode* node = new (slot) TreeNode(dataArg, ArenaAllocator<TreeNode*>(this));
+      nodesInLastBlock_++;
+      return node;
+    }
+
+    // Hand out raw memory with the given size and alignment.
+    void* allocateBytes(std::size_t bytes, std::size_t alignment) {
+      std::size_t misalignment = reinterpret_cast<std::uintptr_t>(bytePos_) % alignment;
+      std::size_t padding = misalignment ? alignment - misalignment : 0;
+      if (!bytePos_ || static_cast<std::size_t>(byteEnd_ - bytePos_) < padding + bytes) {
+        // Start a new chunk. Chunks from ::operator new are suitably
+        // aligned for any ordinary type, so no padding is needed.
+        std::size_t chunkSize = BYTES_PER_CHUNK;
+        if (bytes > chunkSize) {
+          chunkSize = bytes;
+        }
+        reserveOneMore(byteChunks_);
+        byteChunks_.push_back(static_cast<char*>(::operator new(chunkSize)));
+        bytePos_ = byteChunks_.back();
+        byteEnd_ = bytePos_ + chunkSize;
+        padding = 0;
+      }
+      void* result = bytePos_ + padding;
+      bytePos_ += padding + bytes;
+      return result;
+    }
+
+    // Destroy every node created so far and free all of the memory.
+    // If neither the node data type nor the aggregate value type needs a
+    // destructor, the nodes are not visited at all, so this only costs one
+    // free per block.
+    void release() {
+      if (!std::is_trivially_destructible<T>::value ||
+          !std::is_trivially_destructible<AggregateSlot<Aggregate>>::value) {
+        for (std::size_t block = 0; block < nodeBlocks_.size(); block++) {
+          std::size_t count = (block + 1 == nodeBlocks_.size()) ? nodesInLastBlock_ : NODES_PER_BLOCK;
+          for (std::size_t i = 0; i < count; i++) {
+            nodeBlocks_[block][i].~TreeNode();
+          }
+        }
+      }
+      for (TreeNode* block : nodeBlocks_) {
+        ::operator delete(block);
+      }
+      for (char* chunk : byteChunks_) {
+        ::operator delete(chunk);
+      }
+      nodeBlocks_.clear();
+      byteChunks_.clear();
+      nodesInLastBlock_ = NODES_PER_BLOCK;
+      bytePos_ = nullptr;
+      byteEnd_ = nullptr;
+    }
+
+  private:
+    static constexpr std::size_t NODES_PER_BLOCK = 1024;
+    static constexpr std::size_t BYTES_PER_CHUNK = 64 * 1024;
+
+    // Make sure one more pointer can be added to a block list without
+    // reallocating, so that push_back can't throw after we've allocated
+    // the block it holds. The list grows geometrically, like push_back
+    // itself would, so adding blocks still takes amortized constant time.
+    template <typename Pointer>
+    static void reserveOneMore(std::vector<Pointer>& blocks) {
+      if (blocks.size() == blocks.capacity()) {
+        blocks.reserve(2 * blocks.size() + 1);
+      }
+    }
+
+    // Raw storage for NODES_PER_BLOCK nodes each. All blocks are full except
+    // the last one, which holds nodesInLastBlock_ nodes.
+    std::vector<TreeNode*> nodeBlocks_;
+    std::size_t nodesInLastBlock_;
+
+    // Raw byte chunks, and the free part of the current chunk.
+    std::vector<char*> byteChunks_;
+    char* bytePos_;
+    char* byteEnd_;
+  };
+
 private:
   // The tree has this pointer to its root node as an entry point,
   // which should be set to nullptr when the tree is empty.
   TreeNode* rootNodePtr;
 
+  // The memory region for the Arena allocation mode, or nullptr when the
+  // nodes are allocated on the heap.
+  std::unique_ptr<NodeArena> arenaPtr_;
+
 public:
 
   // A warning about best practices for designing a class interface:
@@ -134,15 +554,65 @@ public:
   //  children pointers instead. But this is pretty easy to use.)
   void compress();
 
+  // Parallel versions of deleteSubtree and compress for very large trees.
+  // The top levels of the tree are explored until there are several
+  // independent subtrees for each worker thread, and then the threads take
+  // those subtrees one at a time until all of them are done. A threadCount
+  // of 0 means to use one thread per hardware core. These functions don't
+  // print the showDebugMessages output, and the node data types must be
+  // safe to destroy from different threads (as standard types are).
+  // Starting threads costs more than handling a small tree directly, so a
+  // subtree with fewer than PARALLEL_MIN_NODES nodes is simply passed to
+  // deleteSubtree or compress (which do print the debug output).
+  static constexpr std::size_t PARALLEL_MIN_NODES = 2048;
+  void deleteSubtreeParallel(TreeNode* targetRoot, unsigned threadCount = 0);
+  void compressParallel(unsigned threadCount = 0);
+
+  // The cached aggregate of the whole tree, in O(1) time. For an empty
+  // tree, this is the value of a null subtree. (Only available when the
+  // tree was declared with an aggregate policy.)
+  typename Aggregate::value_type aggregate() const {
+    return subtreeAggregate(rootNodePtr);
+  }
+
+  // The cached aggregate of the subtree rooted at the given node, in O(1)
+  // time. A null pointer counts as a null subtree.
+  static typename Aggregate::value_type subtreeAggregate(const TreeNode* subtreeRoot) {
+    return subtreeRoot ? subtreeRoot->aggregate : Aggregate::ofNull();
+  }
+
+  // Recompute all of the cached aggregates from scratch, in O(n) time.
+  // This is only needed after editing node data or childrenPtrs directly.
+  void refreshAggregates() {
+    AggregateMaintenance<Aggregate>::recomputeSubtree(rootNodePtr);
+  }
+
   // Default constructor: Indicate that there is no root (empty tree).
   GenericTree() : showDebugMessages(false), rootNodePtr(nullptr) {}
 
+  // Constructor that chooses how nodes are allocated (see Allocation).
+  explicit GenericTree(Allocation allocation) : GenericTree() {
+    if (Allocation::Arena == allocation) {
+      arenaPtr_.reset(new NodeArena());
+    }
+  }
+
   // Parameter constructor: Creates an empty tree, then adds a root node
   // with the provided data.
   GenericTree(const T& rootData) : GenericTree() {
     createRoot(rootData);
   }
 
+  // Same as above, but with the given allocation mode.
+  GenericTree(const T& rootData, Allocation allocation) : GenericTree(allocation) {
+    createRoot(rootData);
+  }
+
+  // Returns the allocation mode chosen when the tree was constructed.
+  Allocation allocation() const {
+    return arenaPtr_ ? Allocation::Arena : Allocation::Heap;
+  }
+
   // Copy constructor: We will disable it.
   GenericTree(const GenericTree& other) = delete;
 
@@ -151,6 +621,7 @@ public:
 
   void clear() {
     // Use our special function to deallocate the entire tree
+    // (In the Arena mode, this releases the whole arena in one step.)
     deleteSubtree(rootNodePtr);
 
     // In this case, since we targeted rootNodePtr (for the whole tree),
@@ -171,11 +642,49 @@ public:
   // Print the tree to the output stream (for example, std::cout) in a vertical text format
   std::ostream& Print(std::ostream& os) const;
 
+private:
+
+  // Check that the node belongs to this tree, and make its parent (if any)
+  // stop listing it as a child. Returns true if the node is the root of the
+  // whole tree. This is the first step of deleteSubtree.
+  bool detachSubtree(TreeNode* targetRoot);
+
+  // Helpers for the parallel functions.
+
+  // Explore the subtree breadth-first, one level at a time, until the
+  // current level has at least minParts nodes (or the tree runs out).
+  // Every node above that level is appended to upperNodes, and the level
+  // itself is left in frontier. If compressing is true, the upper nodes
+  // have their null children removed as they are explored.
+  static void splitSubtree(TreeNode* subtreeRoot, std::size_t minParts, bool compressing,
+    std::vector<TreeNode*>& upperNodes, std::vector<TreeNode*>& frontier);
+
+  // Whether the subtree has at least minCount nodes. This stops counting
+  // once it gets there, so it only visits about minCount nodes.
+  static bool hasAtLeastNodes(const TreeNode* subtreeRoot, std::size_t minCount);
+
+  // Run work(node) on every node in parts, spread across threadCount threads
+  // (including the calling thread), but never more threads than parts.
+  template <typename Work>
+  static void runOnThreads(const std::vector<TreeNode*>& parts, unsigned threadCount, Work work);
+
+  // Remove the null pointers from a single node's children vector in place.
+  static void compressChildren(TreeNode* node);
+
 };
 
+// In some versions of C++ we have to redeclare constant static members
+// at global scope like this to ensure that the linker doesn't give an error.
+template <typename T, typename Aggregate>
+constexpr std::size_t GenericTree<T, Aggregate>::PARALLEL_MIN_NODES;
+template <typename T, typename Aggregate>
+constexpr std::size_t GenericTree<T, Aggregate>::NodeArena::NODES_PER_BLOCK;
+template <typename T, typename Aggregate>
+constexpr std::size_t GenericTree<T, Aggregate>::NodeArena::BYTES_PER_CHUNK;
+
 // Operator overload that allows stream output syntax
-template <typename T>
-std::ostream& operator<<(std::ostream& os, const GenericTree<T>& tree) {
+template <typename T, typename Aggregate>
+std::ostream& operator<<(std::ostream& os, const GenericTree<T, Aggregate>& tree) {
   return tree.Print(os);
 }
 
@@ -223,8 +732,8 @@ std::ostream& operator<<(std::ostream& os, const GenericTree<T>& tree) {
 // type at global scope, we have to certify that GenericTree<T>::TreeNode
 // is a type by writing "typename" before it as well.
 
-template <typename T>
-typename GenericTree<T>::TreeNode* GenericTree<T>::createRoot(const T& rootData) {
+template <typename T, typename Aggregate>
+typename GenericTree<T, Aggregate>::TreeNode* GenericTree<T, Aggregate>::createRoot(const T& rootData) {
   
   // If the rootNodePtr member variable already has a nonzero value assigned,
   // then the root node already exists, and it's an error to try to recreate it.
@@ -247,17 +756,25 @@ typename GenericTree<T>::TreeNode* GenericTree<T>::createRoot(const T& rootData)
   // argument on the constructor like "TreeNode<T>".
 
   // Construct the root node on the heap with the given data
-  rootNodePtr = new TreeNode(rootData);
+  // (or in the arena, if this tree has one).
+  if (arenaPtr_) {
+    rootNodePtr = arenaPtr_->createNode(rootData);
+  }
+  else {
+    rootNodePtr = new TreeNode(rootData);
+  }
 
   // Return a copy of the root node pointer.
   return rootNodePtr;
 }
 
-template <typename T>
-typename GenericTree<T>::TreeNode* GenericTree<T>::TreeNode::addChild(const T& childData) {
+template <typename T, typename Aggregate>
+typename GenericTree<T, Aggregate>::TreeNode* GenericTree<T, Aggregate>::TreeNode::addChild(const T& childData) {
 
-  // We prepare a new child node with the given data.
-  TreeNode* newChildPtr = new TreeNode(childData);
+  // We prepare a new child node with the given data. If this node's
+  // children vector draws from an arena, the child is created there too.
+  NodeArena* arenaPtr = childrenPtrs.get_allocator().arenaPtr;
+  TreeNode* newChildPtr = arenaPtr ? arenaPtr->createNode(childData) : new TreeNode(childData);
 
   // The "this" pointer in C++ always points to the current instance of the
   //  class for which we are defining a function body.
@@ -270,12 +787,16 @@ typename GenericTree<T>::TreeNode* GenericTree<T>::TreeNode::addChild(const T& c
   // of its children pointers. We add the new child to the list.
   childrenPtrs.push_back(newChildPtr);
 
+  // The new leaf changes the cached aggregates of this node and its
+  // ancestors, if the tree keeps any.
+  AggregateMaintenance<Aggregate>::childAdded(this, newChildPtr);
+
   // Return a copy of the pointer to the new child.
   return newChildPtr;
 }
 
-template <typename T>
-void GenericTree<T>::deleteSubtree(TreeNode* targetRoot) {
+template <typename T, typename Aggregate>
+void GenericTree<T, Aggregate>::deleteSubtree(TreeNode* targetRoot) {
 
   // Deleting a subtree requires deallocating the memory used by the nodes,
   // but since the pointers are stored in the tree itself, we need to
@@ -308,62 +829,19 @@ void GenericTree<T>::deleteSubtree(TreeNode* targetRoot) {
     return;
   }
 
-  // Check that the specified node to delete is in the same tree as this
-  // class instance that's calling the function.
-  {
-    TreeNode* walkBack = targetRoot;
-    while (walkBack->parentPtr) {
-      // Walk back from the targeted node to its ultimate parent, the root.
-      // (The root has no parent, so the walk ends there.)
-      walkBack = walkBack->parentPtr;
-    }
-    // The ultimate root found must be this tree's root. Otherwise we're in
-    // a different tree.
-    if (walkBack != rootNodePtr) {
-      throw std::runtime_error("Tried to delete a node from a different tree");
-    }
-  }
-
+  // Make sure the node is in this tree, and unlink it from its parent.
   // We'll take note whether this is the root of the entire tree.
-  bool targetingWholeTreeRoot = (rootNodePtr == targetRoot);
-
-  // If the subtree root node has a parent, then the parent should no longer
-  // list it as a child. (Otherwise, targetRoot is actually the root of the
-  // whole tree, so it has no parent, and we can skip this section.)
-  if (targetRoot->parentPtr) {
-
-    // A flag for error checking: We need to find the target node
-    // listed as a child of its parent. We will keep track as we search.
-    bool targetWasFound = false;
-    
-    // Loop through the parent's listed children using a reference variable
-    // in a range-based for loop. (Yes, currentChildPtr is a pointer, but
-    // we're accesssing each pointer directly by reference this way, so we
-    // can change the original pointers stored in targetRoot->parentPtr->childrenPtrs
-    // that we are iterating over, instead of acting on temporary copies.)
-    // If the child is found under its parent as expected, overwrite it
-    // in-place with nullptr.
-    for (auto& currentChildPtr : targetRoot->parentPtr->childrenPtrs) {
-      if (currentChildPtr == targetRoot) {
-        // We found where the parent node is pointing to the target
-        // node as its child. Replace that pointer with a null pointer.
-        currentChildPtr = nullptr;
-        // Flag that our search succeeded, for error checking.
-        targetWasFound = true;
-        // Stop looping early. The "break" statement exits the current "for"
-        // loop and moves on to the next statement outside.
-        break;
-      }
-    }
-
-    // If the target node was not found, our tree is malformed somehow.
-    if (!targetWasFound) {
-      // If this flag is still false, we have some kind of bug.
-      // The target should have been listed as a child of its parent.
-      constexpr char ERROR_MESSAGE[] = "Target node to delete was not listed as a child of its parent";
-      std::cerr << ERROR_MESSAGE << std::endl;
-      throw std::runtime_error(ERROR_MESSAGE);
+  bool targetingWholeTreeRoot = detachSubtree(targetRoot);
+
+  // In the Arena mode, we don't delete nodes one at a time. A detached
+  // subtree stays in the arena until the whole tree goes away, and then
+  // the whole arena is released at once.
+  if (arenaPtr_) {
+    if (targetingWholeTreeRoot) {
+      arenaPtr_->release();
+      rootNodePtr = nullptr;
     }
+    return;
   }
 
   // Now, we need to make sure all the descendents get deleted. We have to
@@ -497,8 +975,76 @@ void GenericTree<T>::deleteSubtree(TreeNode* targetRoot) {
   return;
 }
 
-template <typename T>
-void GenericTree<T>::compress() {
+template <typename T, typename Aggregate>
+bool GenericTree<T, Aggregate>::detachSubtree(TreeNode* targetRoot) {
+
+  // Check that the specified node to delete is in the same tree as this
+  // class instance that's calling the function.
+  {
+    TreeNode* walkBack = targetRoot;
+    while (walkBack->parentPtr) {
+      // Walk back from the targeted node to its ultimate parent, the root.
+      // (The root has no parent, so the walk ends there.)
+      walkBack = walkBack->parentPtr;
+    }
+    // The ultimate root found must be this tree's root. Otherwise we're in
+    // a different tree.
+    if (walkBack != rootNodePtr) {
+      throw std::runtime_error("Tried to delete a node from a different tree");
+    }
+  }
+
+  // We'll take note whether this is the root of the entire tree.
+  bool targetingWholeTreeRoot = (rootNodePtr == targetRoot);
+
+  // If the subtree root node has a parent, then the parent should no longer
+  // list it as a child. (Otherwise, targetRoot is actually the root of the
+  // whole tree, so it has no parent, and we can skip this section.)
+  if (targetRoot->parentPtr) {
+
+    // A flag for error checking: We need to find the target node
+    // listed as a child of its parent. We will keep track as we search.
+    bool targetWasFound = false;
+    
+    // Loop through the parent's listed children using a reference variable
+    // in a range-based for loop. (Yes, currentChildPtr is a pointer, but
+    // we're accesssing each pointer directly by reference this way, so we
+    // can change the original pointers stored in targetRoot->parentPtr->childrenPtrs
+    // that we are iterating over, instead of acting on temporary copies.)
+    // If the child is found under its parent as expected, overwrite it
+    // in-place with nullptr.
+    for (auto& currentChildPtr : targetRoot->parentPtr->childrenPtrs) {
+      if (currentChildPtr == targetRoot) {
+        // We found where the parent node is pointing to the target
+        // node as its child. Replace that pointer with a null pointer.
+        currentChildPtr = nullptr;
+        // Flag that our search succeeded, for error checking.
+        targetWasFound = true;
+        // Stop looping early. The "break" statement exits the current "for"
+        // loop and moves on to the next statement outside.
+        break;
+      }
+    }
+
+    // If the target node was not found, our tree is malformed somehow.
+    if (!targetWasFound) {
+      // If this flag is still false, we have some kind of bug.
+      // The target should have been listed as a child of its parent.
+      constexpr char ERROR_MESSAGE[] = "Target node to delete was not listed as a child of its parent";
+      std::cerr << ERROR_MESSAGE << std::endl;
+      throw std::runtime_error(ERROR_MESSAGE);
+    }
+
+    // The parent now has a null child in place of the subtree, so the
+    // cached aggregates above it (if any) need to reflect that.
+    AggregateMaintenance<Aggregate>::childRemoved(targetRoot->parentPtr, targetRoot);
+  }
+
+  return targetingWholeTreeRoot;
+}
+
+template <typename T, typename Aggregate>
+void GenericTree<T, Aggregate>::compress() {
 
   // We'll use an iterative approach to traversing the tree here.
   // In this function, we don't ever want to push null pointers onto the
@@ -533,7 +1079,8 @@ void GenericTree<T>::compress() {
     // If the node exists, it may have children pointers. Let's make
     // an empty vector of children node pointers and get ready to make
     // a compressed copy of this node's children pointers.
-    std::vector<TreeNode*> compressedChildrenPtrs;
+    // (It uses the same allocator as the vector it will replace.)
+    ChildrenPtrVector compressedChildrenPtrs(frontNode->childrenPtrs.get_allocator());
     // Now loop through the currently recorded children pointers...
     for (auto childPtr : frontNode->childrenPtrs) {
       if (childPtr) {
@@ -554,20 +1101,215 @@ void GenericTree<T>::compress() {
     frontNode->childrenPtrs.swap(compressedChildrenPtrs);
   }
 
+  // Removing null children can change the cached aggregates (such as a
+  // count of null children), so recompute them if the tree keeps any.
+  AggregateMaintenance<Aggregate>::recomputeSubtree(rootNodePtr);
+
+}
+
+template <typename T, typename Aggregate>
+void GenericTree<T, Aggregate>::splitSubtree(TreeNode* subtreeRoot, std::size_t minParts, bool compressing,
+  std::vector<TreeNode*>& upperNodes, std::vector<TreeNode*>& frontier) {
+
+  frontier.assign(1, subtreeRoot);
+  std::vector<TreeNode*> nextLevel;
+
+  while (!frontier.empty() && frontier.size() < minParts) {
+    nextLevel.clear();
+    for (TreeNode* node : frontier) {
+      if (compressing) {
+        compressChildren(node);
+      }
+      for (TreeNode* childPtr : node->childrenPtrs) {
+        if (childPtr) {
+          nextLevel.push_back(childPtr);
+        }
+      }
+      upperNodes.push_back(node);
+    }
+    frontier.swap(nextLevel);
+  }
+}
+
+template <typename T, typename Aggregate>
+bool GenericTree<T, Aggregate>::hasAtLeastNodes(const TreeNode* subtreeRoot, std::size_t minCount) {
+
+  std::size_t count = 0;
+  std::vector<const TreeNode*> nodesToCount;
+  if (subtreeRoot) {
+    nodesToCount.push_back(subtreeRoot);
+  }
+  while (!nodesToCount.empty() && count < minCount) {
+    const TreeNode* curNode = nodesToCount.back();
+    nodesToCount.pop_back();
+    count++;
+    for (const TreeNode* childPtr : curNode->childrenPtrs) {
+      if (childPtr) {
+        nodesToCount.push_back(childPtr);
+      }
+    }
+  }
+  return count >= minCount;
 }
 
-template <typename T>
-std::ostream& GenericTree<T>::Print(std::ostream& os) const {
+template <typename T, typename Aggregate>
+template <typename Work>
+void GenericTree<T, Aggregate>::runOnThreads(const std::vector<TreeNode*>& parts, unsigned threadCount, Work work) {
+
+  // Subtrees can have very different sizes, so instead of handing each
+  // thread a fixed share up front, each thread claims the next unclaimed
+  // part whenever it finishes one.
+  std::atomic<std::size_t> nextPart(0);
+  auto worker = [&]() {
+    for (std::size_t i = nextPart++; i < parts.size(); i = nextPart++) {
+      work(parts[i]);
+    }
+  };
+
+  // A thread with no part to take would only be started and joined.
+  const std::size_t threadsToUse = std::min<std::size_t>(threadCount, parts.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < threadsToUse; i++) {
+    threads.emplace_back(worker);
+  }
+  // The calling thread does its share of the work too.
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+template <typename T, typename Aggregate>
+void GenericTree<T, Aggregate>::compressChildren(TreeNode* node) {
+  auto& children = node->childrenPtrs;
+  children.erase(std::remove(children.begin(), children.end(), nullptr), children.end());
+}
+
+template <typename T, typename Aggregate>
+void GenericTree<T, Aggregate>::deleteSubtreeParallel(TreeNode* targetRoot, unsigned threadCount) {
+
+  if (nullptr == targetRoot) {
+    return;
+  }
+
+  if (!arenaPtr_ && !hasAtLeastNodes(targetRoot, PARALLEL_MIN_NODES)) {
+    deleteSubtree(targetRoot);
+    return;
+  }
+
+  bool targetingWholeTreeRoot = detachSubtree(targetRoot);
+
+  // Nothing to delete node by node in the Arena mode (see deleteSubtree).
+  if (arenaPtr_) {
+    if (targetingWholeTreeRoot) {
+      arenaPtr_->release();
+      rootNodePtr = nullptr;
+    }
+    return;
+  }
+
+  if (0 == threadCount) threadCount = std::thread::hardware_concurrency();
+  if (0 == threadCount) threadCount = 1;
+
+  // Several parts per thread helps balance the load when subtrees are uneven.
+  std::vector<TreeNode*> upperNodes;
+  std::vector<TreeNode*> frontier;
+  splitSubtree(targetRoot, 4 * static_cast<std::size_t>(threadCount), false, upperNodes, frontier);
+
+  // Each frontier subtree is deleted by one thread. Since a node's children
+  // pointers are read before the node is deleted, a single stack is enough.
+  runOnThreads(frontier, threadCount, [](TreeNode* subtreeRoot) {
+    std::vector<TreeNode*> nodesToDelete(1, subtreeRoot);
+    while (!nodesToDelete.empty()) {
+      TreeNode* curNode = nodesToDelete.back();
+      nodesToDelete.pop_back();
+      for (TreeNode* childPtr : curNode->childrenPtrs) {
+        if (childPtr) {
+          nodesToDelete.push_back(childPtr);
+        }
+      }
+      delete curNode;
+    }
+  });
+
+  // The nodes above the frontier only point to nodes that are already gone,
+  // so they can be deleted in any order.
+  for (TreeNode* node : upperNodes) {
+    delete node;
+  }
+
+  if (targetingWholeTreeRoot) {
+    rootNodePtr = nullptr;
+  }
+}
+
+template <typename T, typename Aggregate>
+void GenericTree<T, Aggregate>::compressParallel(unsigned threadCount) {
+
+  if (!rootNodePtr) return;
+
+  if (!hasAtLeastNodes(rootNodePtr, PARALLEL_MIN_NODES)) {
+    compress();
+    return;
+  }
+
+  if (0 == threadCount) threadCount = std::thread::hardware_concurrency();
+  if (0 == threadCount) threadCount = 1;
+
+  std::vector<TreeNode*> upperNodes;
+  std::vector<TreeNode*> frontier;
+  splitSubtree(rootNodePtr, 4 * static_cast<std::size_t>(threadCount), true, upperNodes, frontier);
+
+  // Compressing one node only touches that node's own children vector,
+  // so separate subtrees can be compressed at the same time.
+  runOnThreads(frontier, threadCount, [](TreeNode* subtreeRoot) {
+    std::vector<TreeNode*> nodesToExplore(1, subtreeRoot);
+    while (!nodesToExplore.empty()) {
+      TreeNode* curNode = nodesToExplore.back();
+      nodesToExplore.pop_back();
+      compressChildren(curNode);
+      for (TreeNode* childPtr : curNode->childrenPtrs) {
+        nodesToExplore.push_back(childPtr);
+      }
+    }
+    // Each thread also refreshes the cached aggregates of its own subtree.
+    AggregateMaintenance<Aggregate>::recomputeSubtree(subtreeRoot);
+  });
+
+  // Then the nodes above the frontier are refreshed from the bottom up;
+  // upperNodes is in level order, so we go through it backward.
+  for (auto it = upperNodes.rbegin(); it != upperNodes.rend(); it++) {
+    AggregateMaintenance<Aggregate>::recompute(*it);
+  }
+}
+
+template <typename T, typename Aggregate>
+std::ostream& GenericTree<T, Aggregate>::Print(std::ostream& os) const {
 
   // For the text terminal, we'd like to print trees vertically in such a way
   // that the leftmost (or first) children are displayed first vertically.
   // The rightmost children will be displayed lowest and last.
   // Indentation levels will show the nesting of the subtrees.
-
-  // We can do this by printing the nodes with a pre-order traversal.
-  // Here, we implement this technique iteratively with loops and STL data
-  // structures. This function also contains some commentary about "iterators"
-  // in the standard template library.
+  // For example, a root A with children B (which has a child C) and D is
+  // displayed like this:
+  //
+  //   A
+  //   |
+  //   |_ B
+  //   |  |
+  //   |  |_ C
+  //   |
+  //   |_ D
+  //
+  // We do this with an iterative pre-order traversal. Every node below the
+  // root takes two rows: a spacer row that continues the stems, and a row
+  // that shows the data item on a horizontal stem. To the left of those is
+  // the "margin", with one column per ancestor (not counting the root). An
+  // ancestor's column shows a running stem "|  " if it still has siblings
+  // below it to display, and blank space "   " if it was its parent's last
+  // child. The margin only changes by one column as we go down or up one
+  // level, so we keep a single string of it and add or remove columns,
+  // rather than building a new margin for every node.
 
   // Make a const copy of the root node pointer. The const status helps us
   // avoid altering the tree by mistake. By defining a local variable with
@@ -575,211 +1317,88 @@ std::ostream& GenericTree<T>::Print(std::ostream& os) const {
   // accessible by prepending with "this->":
   const TreeNode* rootNodePtr = this->rootNodePtr;
 
-  // Now that the pointer is const, if we tried to do this, the compiler
-  // would give an error and stop us:
-  // rootNodePtr->data = "This won't compile";
-
   // Base case: When the tree is empty
   if (nullptr == rootNodePtr) {
     return os << "[empty tree]" << std::endl;
   }
 
-  // Our stack of nodes that still need to be explored and printed
-  std::stack<const TreeNode*> nodesToExplore;
-  nodesToExplore.push(rootNodePtr);
-
-  // We'll have a depth number associated with every node we find.
-  // Begin tracking the current depth at 0.
-  std::stack<int> depthStack;
-  depthStack.push(0);
-
-  // We'll also track which remaining branches need to be displayed in the
-  // margin when the current node is printed. This is purely stylistic, but
-  // it makes the print output much clearer.
-
-  // A vector of bool will track the margin graphics for each node;
-  // Each entry set to true means to display a vertical branch symbol;
-  // each entry set to false means to display a blank space.
-  std::stack< std::vector<bool> > curMarginStack;
-  // Begin with no margin for depth 0.
-  curMarginStack.push( std::vector<bool>() );
-  // Each node's margin graphics will be based on the trailing lines that
-  // are still running parallel in the margin.
-  std::stack< std::vector<bool> > trailingMarginStack;
-  trailingMarginStack.push( std::vector<bool>() );
-
-  // Now, we want to "explore" each node by adding its children to the top
-  // of the explore stack. Perhaps we'd like to push the rightmost children
-  // onto the stack first, so that when we pop them off of the stack, we pop
-  // the leftmost children first, exploring the left-most branch first.
-  // To push the children onto the stack from right to left, we'll need to
-  // iterate over the node's immediate children in reverse order. How?
-  
-  // Here, we're using a std::vector for each node's collection of childrenPtrs.
-  // The std::vector class allows index-based lookups like an array using [],
-  // which is potentially unsafe if the index given is out of bounds,
-  // or alternatively using .at(), which checks that the index is legal
-  // and throws an exception otherwise. So, being careful, we could write
-  // such a loop like this:
-
-  // // Iterating over a std::vector in reverse order with [] index notation
-  // for (int i = curNode->childrenPtrs.size() - 1; i>=0; i--) {
-  //   // do something here with curNode->childrenPtrs[i]
-  // }
-
-  // However, there's another way. Many of the data structures in the
-  // Standard Template Library (STL) such as std::vector allow you to
-  // iterate in easily and safely using templated "iterator" or "reverse
-  // iterator" classes, which can be dereferenced with similar syntax to
-  // pointers. We can get a "reverse begin" iterator by calling rbegin(),
-  // which will actually point to the end of our std::vector. Then, we can
-  // use it to automatically iterate in reverse order until it reaches
-  // rend(), which happens after it passes the beginning of the std::vector
-  // in reverse order.
-
-  // STL iterators are helpful because they avoid raw pointer manipulations.
-  // as well as index-based lookups on a std::vector, where you might get
-  // an out-of-bounds error or an off-by-one error. However, iterators also
-  // can be invalidated if the data structure changes while you're iterating
-  // (for example, if an item is added or removed, instead of just read or
-  // edited in-place).
-
-  // The rest of the function below makes use of both forward and reverse
-  // iterators.
-
-  while (!nodesToExplore.empty()) {
-
-    // Get a copy of the top pointer on the explore stack.
-    const TreeNode* curNode = nodesToExplore.top();
-
-    // Now that we've retrieved the top pointer, we can pop it from the explore stack.
-    nodesToExplore.pop();
-
-    // Pop the current depth for the node being explored.
-    int curDepth = depthStack.top();
-    depthStack.pop();
-
-    // Pop the current and trailing margin graphic flags for this node.
-    std::vector<bool> curMargin = curMarginStack.top();
-    curMarginStack.pop();
-    std::vector<bool> trailingMargin = trailingMarginStack.top();
-    trailingMarginStack.pop();
+  // Writing to the stream one small piece at a time (and flushing it after
+  // every line with std::endl) is slow for large trees, so the output is
+  // collected in a large buffer and handed to os in big blocks. The data
+  // items are formatted by a stream that uses the same settings as os, so
+  // they look the same as if they were written to os directly.
+  // The debug messages go to both os and std::cerr, so in that case we
+  // write directly to os to keep the two in order.
+  TreePrintBuffer printBuffer(os);
+  std::ostream bufferedStream(&printBuffer);
+  bufferedStream.copyfmt(os);
+  std::ostream& out = showDebugMessages ? os : bufferedStream;
+
+  // Each entry on the stack is a node whose children are being displayed,
+  // along with the index of the next child to display.
+  struct Frame {
+    const TreeNode* node;
+    std::size_t nextChild;
+  };
+  std::vector<Frame> frames;
+  std::string margin;
 
+  // Display one node at the given depth, using the current margin.
+  auto printNode = [&](const TreeNode* node, std::size_t depth) {
     if (showDebugMessages) {
       // Simplified numerical output for debugging.
-      os << "Depth: " << curDepth;
+      os << "Depth: " << depth;
       std::cerr << " Data: ";
-      if (curNode) {
-        // if curNode isn't null, we can show what it contains
-        std::cerr << curNode->data << std::endl;
+      if (node) {
+        // if node isn't null, we can show what it contains
+        std::cerr << node->data << std::endl;
       }
       else {
         std::cerr << "[null]" << std::endl;
       }
+      return;
     }
-    else {
-      // Print the tree as vertical character art.
-      // Display two rows for each node: The first row adds vertical space
-      // for clarity (while continuing the trailing stems), and the second
-      // row displays the actual data item on a horizontal stem.
 
-      constexpr int LAST_ROW = 2;
-
-      for (int row = 1; row<=LAST_ROW; row++) {
-        // Iterate forward through the margin display flags to fill in the margin.
-        for (auto stemIt = curMargin.begin(); stemIt != curMargin.end(); stemIt++) {
-
-          bool showStem = *stemIt;
-          std::string stemSymbol = "|";
-          if (!showStem) {
-            stemSymbol = " ";
-          }
-
-          bool isLastCol = false;
-          if (stemIt + 1 == curMargin.end()) {
-            isLastCol = true;
-          }
-
-          if (isLastCol) {
-            if (LAST_ROW==row) {
-              // The stem before the data item should always be "|_ " in effect:
-              os << stemSymbol << "_ ";
-            }
-            else if (showStem) {
-              // Display a stem and a newline
-              os << stemSymbol << std::endl;
-            }
-            else {
-              // Don't bother displaying trailing spaces before the newline
-              os << std::endl;
-            }
-          }
-          else {
-            // Display a stem (or a blank) and some padding spaces
-            os << stemSymbol << "  ";
-          }
+    if (depth > 0) {
+      out << margin << "|\n" << margin << "|_ ";
+    }
+    if (node) {
+      out << node->data << '\n';
+    }
+    else {
+      out << "[null]\n";
+    }
+  };
 
-          // Bottom of loop for margin stems
-        }
+  printNode(rootNodePtr, 0);
+  frames.push_back(Frame{rootNodePtr, 0});
 
-        // Bottom of loop for multi-row display
-      }
+  while (!frames.empty()) {
+    Frame& frame = frames.back();
+    const auto& children = frame.node->childrenPtrs;
 
-      // At the end of the second row, output the data. The root node data
-      // is displayed alone on the first line correctly.)
-      if (curNode) {
-        os << curNode->data << std::endl;
+    if (frame.nextChild == children.size()) {
+      // Done with this node's children. Going back up a level removes the
+      // node's column from the margin (the root never added one).
+      frames.pop_back();
+      if (!frames.empty()) {
+        margin.resize(margin.size() - 3);
       }
-      else {
-        os << "[null]" << std::endl;;
-      }
-
+      continue;
     }
 
-    // If this node is non-null and has any children...
-    if (curNode && curNode->childrenPtrs.size() > 0) {
-
-      // Now, we iterate over childrenPtrs in reverse order. The iterator "it"
-      // will begin at the "reverse beginning", and we'll iterate it as long as
-      // it's not the "reverse ending". When we do it++, we do iterate in the
-      // reverse direction correctly.
-      for (auto it = curNode->childrenPtrs.rbegin(); it != curNode->childrenPtrs.rend(); it++) {
-        
-        // The iterator points to one child pointer. So here, the iterator is
-        // like a pointer-to-pointer. By dereferencing the iterator, we get a
-        // child pointer value. We can save a temporary copy of that child pointer
-        // to a local variable.
-        const TreeNode* childPtr = *it;
-
-        // Now, push the child pointer onto the stack of children to explore.
-        nodesToExplore.push(childPtr);
-        
-        // Record the depth that corresponds to the child node.
-        depthStack.push(curDepth+1);
-        
-        // Prepare a working copy of the margin for the node we're pushing.
-        auto nextMargin = trailingMargin;
-        // All nodes get an extra stem glyph next to their printout.
-        nextMargin.push_back(true);
-        curMarginStack.push(nextMargin);
-        
-        // But for the trailing margin, we need to leave the rightmost child
-        // with a blank trailing in the margin, because it's displayed lowest.
-        auto nextTrailingMargin = trailingMargin;
-        if (curNode->childrenPtrs.rbegin() == it) {
-          // This is the rightmost child. Leave a blank trailing.
-          nextTrailingMargin.push_back(false);
-        }
-        else {
-          // Other children leave a vertical stem symbol trailing in the margin.
-          nextTrailingMargin.push_back(true);
-        }
-        trailingMarginStack.push(nextTrailingMargin);
+    bool isLastChild = (frame.nextChild + 1 == children.size());
+    const TreeNode* childPtr = children[frame.nextChild++];
+    printNode(childPtr, frames.size());
 
-      }
+    // Null children and leaves have nothing more to display below them.
+    if (childPtr && !childPtr->childrenPtrs.empty()) {
+      margin += isLastChild ? "   " : "|  ";
+      frames.push_back(Frame{childPtr, 0});
     }
-
   }
 
+  out.flush();
+  os.flush();
   return os;
 }
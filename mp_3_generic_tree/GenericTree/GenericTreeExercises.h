@@ -310,12 +310,12 @@ int countNullChildrenIterative(N* subtreeRoot) {
 // traverseLevels: Performs a level-order traversal of the input tree
 // and records copies of the data found, in order, in a std::vector,
 // which should then be returned.
-template <typename T>
-std::vector<T> traverseLevels(GenericTree<T>& tree) {
+template <typename T, typename Aggregate>
+std::vector<T> traverseLevels(GenericTree<T, Aggregate>& tree) {
 
   // This defines a type alias for the appropriate TreeNode dependent type.
   // This might be convenient.
-  using TreeNode = typename GenericTree<T>::TreeNode;
+  using TreeNode = typename GenericTree<T, Aggregate>::TreeNode;
 
   // Now you can refer to a pointer to a TreeNode in this function like this.
   // TreeNode* someTreeNodePointer = nullptr;
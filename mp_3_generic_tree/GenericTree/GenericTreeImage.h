@@ -0,0 +1,420 @@
+/**
+ * @file GenericTreeImage.h
+ * University of Illinois CS 400, MOOC 2, Week 3: Generic Tree
+ *
+ * A compact binary format for saving a GenericTree, which can be
+ * memory-mapped and read in place without rebuilding any nodes.
+ *
+**/
+
+#pragma once
+
+#include <cstdint> // for std::uint32_t, std::uint64_t
+#include <cstring> // for std::memcpy
+#include <stdexcept> // for std::runtime_error
+#include <string> // for std::string
+#include <vector> // for std::vector
+#include <ostream> // for std::ostream
+#include <fstream> // for std::ofstream
+#include <iterator> // for std::forward_iterator_tag
+#include <type_traits> // for std::is_trivially_copyable
+
+// POSIX headers for memory-mapping files
+#include <fcntl.h> // for open
+#include <sys/mman.h> // for mmap, munmap
+#include <sys/stat.h> // for fstat
+#include <unistd.h> // for close
+
+#include "GenericTree.h"
+
+// -------------------------------------------------------------------
+// Tree image format
+// -------------------------------------------------------------------
+// A tree image stores the nodes of a tree in pre-order (the same order
+// that Print displays them), skipping null children pointers. Because of
+// that order, the first child of node i is always node i+1, and the next
+// sibling of a child c is node c + (size of c's subtree). So the tree's
+// structure can be described with two integers per node, and no pointers:
+//
+//   header          TreeImageHeader (below)
+//   childCounts     uint32_t[nodeCount]  number of children of each node
+//   subtreeSizes    uint32_t[nodeCount]  number of nodes in each subtree
+//   (padding up to the alignment of T)
+//   data            T[nodeCount]         the data items, copied byte for byte
+//
+// Only trivially copyable data types (like int or double, or plain structs
+// of them) can be stored this way, because the bytes of the data items are
+// written out directly. The integers are also written in the machine's own
+// byte order, so an image should be read on the same kind of machine that
+// wrote it.
+
+struct TreeImageHeader {
+  // Identifies the file format: the characters "GTRI".
+  std::uint32_t magic;
+  std::uint32_t version;
+  // sizeof(T) and alignof(T) for the data type that was written.
+  std::uint32_t dataSize;
+  std::uint32_t dataAlignment;
+  std::uint64_t nodeCount;
+
+  // These are only ever used as plain values, never by reference or by
+  // address, so they don't need a definition outside the class. (This
+  // library is header-only, and such a definition here would be repeated
+  // in every file that includes it.)
+  static constexpr std::uint32_t MAGIC = 0x49525447u; // "GTRI" in little-endian
+  static constexpr std::uint32_t VERSION = 1;
+
+  // Offset of the data array from the start of the image.
+  static std::uint64_t dataOffset(std::uint64_t nodeCount, std::uint64_t dataAlignment) {
+    std::uint64_t offset = sizeof(TreeImageHeader) + 2 * sizeof(std::uint32_t) * nodeCount;
+    return (offset + dataAlignment - 1) / dataAlignment * dataAlignment;
+  }
+};
+
+// -------------------------------------------------------------------
+// TreeImageView<T> class
+// -------------------------------------------------------------------
+// Read-only access to a tree image that is already in memory, such as a
+// memory-mapped file (see MappedTreeImage below). Nothing is copied: the
+// view just points into the image. Nodes are identified by their pre-order
+// index, and the root is node 0.
+
+template <typename T>
+class TreeImageView {
+public:
+  static_assert(std::is_trivially_copyable<T>::value, "Tree images can only hold trivially copyable data");
+
+  using NodeIndex = std::uint32_t;
+
+  // Iterates over the indices of one node's children, left to right.
+  class ChildIterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = NodeIndex;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const NodeIndex*;
+    using reference = NodeIndex;
+
+    ChildIterator(const TreeImageView* viewArg, NodeIndex childArg, NodeIndex remainingArg)
+      : view_(viewArg), child_(childArg), remaining_(remainingArg) {}
+
+    NodeIndex operator*() const { return child_; }
+
+    ChildIterator& operator++() {
+      // Skip over the whole subtree of the current child.
+      child_ += view_->subtreeSize(child_);
+      remaining_--;
+      return *this;
+    }
+
+    ChildIterator operator++(int) {
+      ChildIterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    // Two iterators over the same children are equal when the same number
+    // of children remain.
+    bool operator==(const ChildIterator& other) const { return remaining_ == other.remaining_; }
+    bool operator!=(const ChildIterator& other) const { return remaining_ != other.remaining_; }
+
+  private:
+    const TreeImageView* view_;
+    NodeIndex child_;
+    NodeIndex remaining_;
+  };
+
+  class ChildRange {
+  public:
+    ChildRange(const TreeImageView* viewArg, NodeIndex parentArg) : view_(viewArg), parent_(parentArg) {}
+    ChildIterator begin() const { return ChildIterator(view_, parent_ + 1, view_->childCount(parent_)); }
+    ChildIterator end() const { return ChildIterator(view_, 0, 0); }
+  private:
+    const TreeImageView* view_;
+    NodeIndex parent_;
+  };
+
+  // An empty view with no nodes.
+  TreeImageView() : nodeCount_(0), childCounts_(nullptr), subtreeSizes_(nullptr), data_(nullptr) {}
+
+  // Check the image and set up the view. Throws std::runtime_error if the
+  // bytes don't hold a valid image for this data type, including when the
+  // child counts and subtree sizes don't describe a tree, so a corrupted
+  // file can't make the view or buildTreeFromImage read out of bounds.
+  TreeImageView(const void* image, std::size_t imageBytes);
+
+  // Number of nodes in the tree.
+  std::size_t size() const { return nodeCount_; }
+  bool empty() const { return 0 == nodeCount_; }
+
+  NodeIndex childCount(NodeIndex index) const { return childCounts_[index]; }
+  NodeIndex subtreeSize(NodeIndex index) const { return subtreeSizes_[index]; }
+  const T& data(NodeIndex index) const { return data_[index]; }
+
+  // The children of a node, for use in a range-based for loop.
+  ChildRange children(NodeIndex index) const { return ChildRange(this, index); }
+
+  // All data items in pre-order, as a plain array.
+  const T* dataArray() const { return data_; }
+
+private:
+  std::size_t nodeCount_;
+  const std::uint32_t* childCounts_;
+  const std::uint32_t* subtreeSizes_;
+  const T* data_;
+};
+
+// -------------------------------------------------------------------
+// MappedTreeImage<T> class
+// -------------------------------------------------------------------
+// Memory-maps a tree image file for reading. The operating system loads
+// pages of the file on demand, so opening even a very large image is
+// nearly instant, and the tree can be read right away through view().
+// The mapping is released when this object is destroyed.
+
+template <typename T>
+class MappedTreeImage {
+public:
+  explicit MappedTreeImage(const std::string& filename);
+
+  // Disable copying, since this object owns the mapping.
+  MappedTreeImage(const MappedTreeImage& other) = delete;
+  MappedTreeImage& operator=(const MappedTreeImage& other) = delete;
+
+  ~MappedTreeImage() {
+    if (mapping_) {
+      munmap(mapping_, mappingBytes_);
+    }
+  }
+
+  const TreeImageView<T>& view() const { return view_; }
+
+private:
+  void* mapping_;
+  std::size_t mappingBytes_;
+  TreeImageView<T> view_;
+};
+
+// =======================================================================
+//   Implementation section
+// =======================================================================
+
+// Write the tree to the output stream as a tree image. The stream should
+// be opened in binary mode.
+template <typename T, typename Aggregate>
+void writeTreeImage(GenericTree<T, Aggregate>& tree, std::ostream& os) {
+  static_assert(std::is_trivially_copyable<T>::value, "Tree images can only hold trivially copyable data");
+
+  using TreeNode = typename GenericTree<T, Aggregate>::TreeNode;
+
+  // Collect the nodes in pre-order with the index of each node's parent.
+  std::vector<const TreeNode*> nodes;
+  std::vector<std::uint32_t> parents;
+  {
+    struct Entry {
+      const TreeNode* node;
+      std::uint32_t parent;
+    };
+    std::vector<Entry> nodesToExplore;
+    if (tree.getRootPtr()) {
+      nodesToExplore.push_back(Entry{tree.getRootPtr(), 0});
+    }
+    while (!nodesToExplore.empty()) {
+      Entry cur = nodesToExplore.back();
+      nodesToExplore.pop_back();
+      std::uint32_t curIndex = static_cast<std::uint32_t>(nodes.size());
+      nodes.push_back(cur.node);
+      parents.push_back(cur.parent);
+      // Push right to left, so the leftmost child is visited next.
+      const auto& children = cur.node->childrenPtrs;
+      for (auto it = children.rbegin(); it != children.rend(); it++) {
+        if (*it) nodesToExplore.push_back(Entry{*it, curIndex});
+      }
+    }
+  }
+
+  // Every node comes after its parent in pre-order, so one backward pass
+  // adds each finished subtree's size into its parent.
+  std::vector<std::uint32_t> childCounts(nodes.size(), 0);
+  std::vector<std::uint32_t> subtreeSizes(nodes.size(), 1);
+  for (std::size_t i = nodes.size(); i-- > 1; ) {
+    subtreeSizes[parents[i]] += subtreeSizes[i];
+    childCounts[parents[i]]++;
+  }
+
+  TreeImageHeader header;
+  header.magic = TreeImageHeader::MAGIC;
+  header.version = TreeImageHeader::VERSION;
+  header.dataSize = sizeof(T);
+  header.dataAlignment = alignof(T);
+  header.nodeCount = nodes.size();
+
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  os.write(reinterpret_cast<const char*>(childCounts.data()), childCounts.size() * sizeof(std::uint32_t));
+  os.write(reinterpret_cast<const char*>(subtreeSizes.data()), subtreeSizes.size() * sizeof(std::uint32_t));
+
+  std::uint64_t written = sizeof(header) + 2 * sizeof(std::uint32_t) * nodes.size();
+  std::uint64_t padding = TreeImageHeader::dataOffset(nodes.size(), alignof(T)) - written;
+  for (std::uint64_t i = 0; i < padding; i++) {
+    os.put('\0');
+  }
+
+  for (const TreeNode* node : nodes) {
+    os.write(reinterpret_cast<const char*>(&node->data), sizeof(T));
+  }
+
+  if (!os) {
+    throw std::runtime_error("Failed to write tree image");
+  }
+}
+
+// Write the tree to a file as a tree image.
+template <typename T, typename Aggregate>
+void saveTreeImage(GenericTree<T, Aggregate>& tree, const std::string& filename) {
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error("Could not open tree image file for writing: " + filename);
+  }
+  writeTreeImage(tree, file);
+}
+
+// Rebuild an ordinary GenericTree from a tree image, replacing whatever
+// the tree held before. (This is only needed when the tree must be edited;
+// otherwise the image can be read directly through its view.)
+template <typename T, typename Aggregate>
+void buildTreeFromImage(const TreeImageView<T>& view, GenericTree<T, Aggregate>& tree) {
+  using TreeNode = typename GenericTree<T, Aggregate>::TreeNode;
+
+  tree.clear();
+  if (view.empty()) return;
+
+  // A stack of nodes that are still waiting for more children, with the
+  // number of children they still need.
+  struct Entry {
+    TreeNode* node;
+    std::uint32_t remaining;
+  };
+  std::vector<Entry> openNodes;
+  openNodes.push_back(Entry{tree.createRoot(view.data(0)), view.childCount(0)});
+
+  for (std::uint32_t i = 1; i < view.size(); i++) {
+    while (!openNodes.empty() && 0 == openNodes.back().remaining) {
+      openNodes.pop_back();
+    }
+    // The view has checked the structure already, so this can't happen
+    // unless the image changed underneath it.
+    if (openNodes.empty()) {
+      throw std::runtime_error("Tree image has more nodes than its child counts allow");
+    }
+    openNodes.back().remaining--;
+    TreeNode* child = openNodes.back().node->addChild(view.data(i));
+    openNodes.push_back(Entry{child, view.childCount(i)});
+  }
+}
+
+template <typename T>
+TreeImageView<T>::TreeImageView(const void* image, std::size_t imageBytes) : TreeImageView() {
+  if (imageBytes < sizeof(TreeImageHeader)) {
+    throw std::runtime_error("Tree image is too small to hold a header");
+  }
+
+  TreeImageHeader header;
+  std::memcpy(&header, image, sizeof(header));
+  if (TreeImageHeader::MAGIC != header.magic || TreeImageHeader::VERSION != header.version) {
+    throw std::runtime_error("Not a tree image, or an unsupported version");
+  }
+  if (sizeof(T) != header.dataSize || alignof(T) != header.dataAlignment) {
+    throw std::runtime_error("Tree image was written for a different data type");
+  }
+  if (header.nodeCount >= 0xFFFFFFFFu) {
+    throw std::runtime_error("Tree image has too many nodes");
+  }
+
+  std::uint64_t dataOffset = TreeImageHeader::dataOffset(header.nodeCount, alignof(T));
+  if (imageBytes < dataOffset + header.nodeCount * sizeof(T)) {
+    throw std::runtime_error("Tree image is truncated");
+  }
+
+  const char* bytes = static_cast<const char*>(image);
+  if (0 != reinterpret_cast<std::uintptr_t>(bytes) % alignof(T)
+    || 0 != reinterpret_cast<std::uintptr_t>(bytes) % alignof(std::uint32_t)) {
+    throw std::runtime_error("Tree image is not suitably aligned in memory");
+  }
+
+  const std::uint32_t* childCounts = reinterpret_cast<const std::uint32_t*>(bytes + sizeof(TreeImageHeader));
+  const std::uint32_t* subtreeSizes = childCounts + header.nodeCount;
+
+  // Check that the counts describe a tree: the root's subtree is the whole
+  // image, and the subtrees of each node's children fit exactly into the
+  // rest of its own subtree. Each node is then some node's child exactly
+  // once, so this takes O(n) time in all, and afterward every child
+  // iteration stays in bounds.
+  const std::uint64_t nodeCount = header.nodeCount;
+  if (nodeCount > 0 && subtreeSizes[0] != nodeCount) {
+    throw std::runtime_error("Tree image has an invalid structure");
+  }
+  for (std::uint64_t i = 0; i < nodeCount; i++) {
+    const std::uint64_t subtreeEnd = i + subtreeSizes[i];
+    if (0 == subtreeSizes[i] || subtreeEnd > nodeCount) {
+      throw std::runtime_error("Tree image has an invalid structure");
+    }
+    std::uint64_t child = i + 1;
+    for (std::uint32_t k = 0; k < childCounts[i]; k++) {
+      if (child >= subtreeEnd) {
+        throw std::runtime_error("Tree image has an invalid structure");
+      }
+      // A zero size is caught when the loop over i gets to this child,
+      // but we must not loop on it before then.
+      if (0 == subtreeSizes[child]) {
+        throw std::runtime_error("Tree image has an invalid structure");
+      }
+      child += subtreeSizes[child];
+    }
+    if (child != subtreeEnd) {
+      throw std::runtime_error("Tree image has an invalid structure");
+    }
+  }
+
+  nodeCount_ = header.nodeCount;
+  childCounts_ = childCounts;
+  subtreeSizes_ = subtreeSizes;
+  data_ = reinterpret_cast<const T*>(bytes + dataOffset);
+}
+
+template <typename T>
+MappedTreeImage<T>::MappedTreeImage(const std::string& filename) : mapping_(nullptr), mappingBytes_(0) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Could not open tree image file: " + filename);
+  }
+
+  struct stat fileInfo;
+  if (fstat(fd, &fileInfo) != 0) {
+    close(fd);
+    throw std::runtime_error("Could not read the size of tree image file: " + filename);
+  }
+  std::size_t fileBytes = static_cast<std::size_t>(fileInfo.st_size);
+
+  void* mapping = nullptr;
+  if (fileBytes > 0) {
+    mapping = mmap(nullptr, fileBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  // The mapping stays valid after the file descriptor is closed.
+  close(fd);
+  if (0 == fileBytes || MAP_FAILED == mapping) {
+    throw std::runtime_error("Could not memory-map tree image file: " + filename);
+  }
+
+  mapping_ = mapping;
+  mappingBytes_ = fileBytes;
+
+  // If the image is invalid, release the mapping before reporting the error,
+  // since the destructor won't run for a constructor that throws.
+  try {
+    view_ = TreeImageView<T>(mapping_, mappingBytes_);
+  }
+  catch (...) {
+    munmap(mapping_, mappingBytes_);
+    throw;
+  }
+}
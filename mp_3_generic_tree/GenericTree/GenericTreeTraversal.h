@@ -0,0 +1,215 @@
+/**
+ * @file GenericTreeTraversal.h
+ * University of Illinois CS 400, MOOC 2, Week 3: Generic Tree
+ *
+ * Lazy level-order and pre-order traversals of a GenericTree.
+ *
+**/
+
+#pragma once
+
+#include <cstddef> // for std::ptrdiff_t
+#include <deque> // for std::deque
+#include <iterator> // for std::input_iterator_tag
+
+#include "GenericTree.h"
+
+// -------------------------------------------------------------------
+// GenericTreeTraversal<T, DepthFirst, Aggregate> class
+// -------------------------------------------------------------------
+// traverseLevels (in GenericTreeExercises.h) visits the whole tree and
+// copies every data item into a std::vector before returning. This class
+// performs the same kind of traversal lazily instead: each step of an
+// iterator visits one more node, and the data is accessed by reference in
+// the tree itself. The caller can stop at any point, and the traversal only
+// stores the nodes that are waiting to be visited (the "frontier"), not
+// the results.
+//
+// With DepthFirst set to false, nodes are visited in level order, exactly
+// like traverseLevels. With DepthFirst set to true, nodes are visited in
+// pre-order, top to bottom and left to right, which is the order that
+// GenericTree::Print displays them in. Null children pointers are skipped.
+//
+// A traversal object can be iterated over only once, like an input stream:
+//
+//   for (auto& data : levelOrder(tree)) { ... }
+//
+// The iterators are standard input iterators, so they can also be used
+// with algorithms like std::find_if. The tree must not be changed while
+// a traversal of it is in progress.
+
+template <typename T, bool DepthFirst, typename Aggregate = NoAggregate>
+class GenericTreeTraversal {
+public:
+
+  using TreeNode = typename GenericTree<T, Aggregate>::TreeNode;
+
+  class iterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    // A default-constructed iterator is the end iterator.
+    iterator() : traversal_(nullptr) {}
+
+    reference operator*() const { return traversal_->current_.node->data; }
+    pointer operator->() const { return &(traversal_->current_.node->data); }
+
+    // Advance to the next node.
+    iterator& operator++() {
+      traversal_->advance();
+      if (!traversal_->current_.node) {
+        traversal_ = nullptr;
+      }
+      return *this;
+    }
+
+    // Post-increment: All iterators of a traversal share its state, so the
+    // old position is kept as a pointer to its data item instead.
+    class PostIncrementProxy {
+    public:
+      explicit PostIncrementProxy(T* dataArg) : data(dataArg) {}
+      T& operator*() const { return *data; }
+    private:
+      T* data;
+    };
+
+    PostIncrementProxy operator++(int) {
+      PostIncrementProxy old(&**this);
+      ++*this;
+      return old;
+    }
+
+    // The depth of the current node (the root has depth 0).
+    int depth() const { return traversal_->current_.depth; }
+
+    // True if the current node is at a different depth than the node
+    // visited before it. In level order, this marks the first node of
+    // each level.
+    bool startsLevel() const { return traversal_->startsLevel_; }
+
+    // The current node itself, for access to its parent or children.
+    TreeNode* node() const { return traversal_->current_.node; }
+
+    bool operator==(const iterator& other) const { return traversal_ == other.traversal_; }
+    bool operator!=(const iterator& other) const { return traversal_ != other.traversal_; }
+
+  private:
+    friend class GenericTreeTraversal;
+    explicit iterator(GenericTreeTraversal* traversalArg) : traversal_(traversalArg) {}
+
+    GenericTreeTraversal* traversal_;
+  };
+
+  // Prepare a traversal of the tree. If maxDepth is not negative, nodes
+  // deeper than maxDepth are never visited (or even queued).
+  explicit GenericTreeTraversal(GenericTree<T, Aggregate>& tree, int maxDepth = -1);
+
+  // Returns an iterator at the current position of the traversal.
+  iterator begin() {
+    return current_.node ? iterator(this) : iterator();
+  }
+
+  iterator end() {
+    return iterator();
+  }
+
+  // Number of nodes queued but not yet visited.
+  std::size_t frontierSize() const { return frontier_.size(); }
+
+private:
+
+  struct Entry {
+    TreeNode* node;
+    int depth;
+  };
+
+  // Nodes waiting to be visited. Level order takes them from the front,
+  // and pre-order takes them from the back (using it as a stack).
+  std::deque<Entry> frontier_;
+
+  // The node being visited now, or a null node when the traversal is done.
+  Entry current_;
+  bool startsLevel_;
+
+  int maxDepth_;
+
+  // Queue the current node's children, in the order that they should be taken.
+  void expandCurrent();
+
+  // Move to the next node.
+  void advance();
+
+};
+
+template <typename T, typename Aggregate = NoAggregate>
+using LevelOrderTraversal = GenericTreeTraversal<T, false, Aggregate>;
+
+template <typename T, typename Aggregate = NoAggregate>
+using PreOrderTraversal = GenericTreeTraversal<T, true, Aggregate>;
+
+// Convenience functions for range-based for loops.
+template <typename T, typename Aggregate>
+LevelOrderTraversal<T, Aggregate> levelOrder(GenericTree<T, Aggregate>& tree, int maxDepth = -1) {
+  return LevelOrderTraversal<T, Aggregate>(tree, maxDepth);
+}
+
+template <typename T, typename Aggregate>
+PreOrderTraversal<T, Aggregate> preOrder(GenericTree<T, Aggregate>& tree, int maxDepth = -1) {
+  return PreOrderTraversal<T, Aggregate>(tree, maxDepth);
+}
+
+// =======================================================================
+//   Implementation section
+// =======================================================================
+
+template <typename T, bool DepthFirst, typename Aggregate>
+GenericTreeTraversal<T, DepthFirst, Aggregate>::GenericTreeTraversal(GenericTree<T, Aggregate>& tree, int maxDepth)
+  : current_{tree.getRootPtr(), 0}, startsLevel_(true), maxDepth_(maxDepth) {
+  if (current_.node) {
+    expandCurrent();
+  }
+}
+
+template <typename T, bool DepthFirst, typename Aggregate>
+void GenericTreeTraversal<T, DepthFirst, Aggregate>::expandCurrent() {
+  int childDepth = current_.depth + 1;
+  if (maxDepth_ >= 0 && childDepth > maxDepth_) return;
+
+  const auto& children = current_.node->childrenPtrs;
+  if (DepthFirst) {
+    // Push right to left, so the leftmost child is on top of the stack.
+    for (auto it = children.rbegin(); it != children.rend(); it++) {
+      if (*it) frontier_.push_back(Entry{*it, childDepth});
+    }
+  }
+  else {
+    for (TreeNode* childPtr : children) {
+      if (childPtr) frontier_.push_back(Entry{childPtr, childDepth});
+    }
+  }
+}
+
+template <typename T, bool DepthFirst, typename Aggregate>
+void GenericTreeTraversal<T, DepthFirst, Aggregate>::advance() {
+  if (frontier_.empty()) {
+    current_.node = nullptr;
+    return;
+  }
+
+  int previousDepth = current_.depth;
+  if (DepthFirst) {
+    current_ = frontier_.back();
+    frontier_.pop_back();
+  }
+  else {
+    current_ = frontier_.front();
+    frontier_.pop_front();
+  }
+  startsLevel_ = (current_.depth != previousDepth);
+
+  expandCurrent();
+}
@@ -6,11 +6,19 @@
 
 #include <cstdlib>
 #include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <limits>
+#include <cstdio>
+#include <cstring>
 
 #include "../uiuc/catch/catch.hpp"
 
 #include "../GenericTree.h"
 #include "../GenericTreeExercises.h"
+#include "../FlatGenericTree.h"
+#include "../GenericTreeTraversal.h"
+#include "../GenericTreeImage.h"
 
 
 TEST_CASE("Displaying manual test output", "[weight=0]") {
@@ -92,3 +100,600 @@ TEST_CASE("Testing traverseLevels", "[weight=2]"){
   }
 }
 
+
+TEST_CASE("Testing FlatGenericTree traverseLevels", "[weight=0]") {
+  std::string expected_traversal = "A B D J K C E I L F G M H ";
+  GenericTree<std::string> tree2("A");
+  auto A = tree2.getRootPtr();
+  A->addChild("B")->addChild("C");
+  auto D = A->addChild("D");
+  auto E = D->addChild("E");
+  E->addChild("F");
+  E->addChild("G")->addChild("H");
+  D->addChild("I");
+  A->addChild("J");
+  auto L = A->addChild("K")->addChild("L");
+  L->addChild("M");
+
+  SECTION("Copy of a GenericTree is stored in level order") {
+    FlatGenericTree<std::string> flat(tree2);
+    REQUIRE(flat.size() == 13);
+    REQUIRE(flat.isLevelOrdered());
+    std::stringstream outstream;
+    for (auto result : traverseLevels(flat)) {
+      outstream << result << " ";
+    }
+    REQUIRE(expected_traversal == outstream.str());
+  }
+
+  SECTION("Tree built depth-first traverses correctly before and after relayout") {
+    // Same shape as tree2, but added in the same order as above.
+    FlatGenericTree<std::string> flat;
+    auto a = flat.createRoot("A");
+    flat.addChild(flat.addChild(a, "B"), "C");
+    auto d = flat.addChild(a, "D");
+    auto e = flat.addChild(d, "E");
+    flat.addChild(e, "F");
+    flat.addChild(flat.addChild(e, "G"), "H");
+    flat.addChild(d, "I");
+    flat.addChild(a, "J");
+    auto l = flat.addChild(flat.addChild(a, "K"), "L");
+    flat.addChild(l, "M");
+    REQUIRE_FALSE(flat.isLevelOrdered());
+
+    std::stringstream before;
+    for (auto result : traverseLevels(flat)) {
+      before << result << " ";
+    }
+    REQUIRE(expected_traversal == before.str());
+
+    flat.relayoutLevelOrder();
+    REQUIRE(flat.isLevelOrdered());
+    std::stringstream after;
+    for (auto result : traverseLevels(flat)) {
+      after << result << " ";
+    }
+    REQUIRE(expected_traversal == after.str());
+  }
+}
+
+// This is hidden because of the [.] tag.
+// You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: traverseLevels on GenericTree vs. FlatGenericTree", "[weight=0][.][bench]") {
+
+  // Each node gets BRANCHING children until there are TREE_SIZE nodes.
+  constexpr int TREE_SIZE = 1000000;
+  constexpr int BRANCHING = 4;
+
+  GenericTree<int> tree(0);
+  {
+    std::queue<GenericTree<int>::TreeNode*> frontier;
+    frontier.push(tree.getRootPtr());
+    int count = 1;
+    while (count < TREE_SIZE) {
+      auto parent = frontier.front();
+      frontier.pop();
+      for (int i = 0; i < BRANCHING && count < TREE_SIZE; i++) {
+        frontier.push(parent->addChild(count++));
+      }
+    }
+  }
+  FlatGenericTree<int> flat(tree);
+
+  std::cout << std::endl << "Level-order traversal of " << TREE_SIZE << " nodes:" << std::endl;
+  {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    auto results = traverseLevels(tree);
+    auto stop_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> dur_ms = stop_time - start_time;
+    if (results.size()) std::cout << "GenericTree: " << dur_ms.count() << "ms" << std::endl;
+  }
+  {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    auto results = traverseLevels(flat);
+    auto stop_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> dur_ms = stop_time - start_time;
+    if (results.size()) std::cout << "FlatGenericTree: " << dur_ms.count() << "ms" << std::endl;
+  }
+}
+
+// Builds a complete tree of the given size where every node has the
+// given number of children, filled in level order.
+static void buildWideTree(GenericTree<int>& tree, int treeSize, int branching) {
+  tree.clear();
+  std::queue<GenericTree<int>::TreeNode*> frontier;
+  frontier.push(tree.createRoot(0));
+  int count = 1;
+  while (count < treeSize) {
+    auto parent = frontier.front();
+    frontier.pop();
+    for (int i = 0; i < branching && count < treeSize; i++) {
+      frontier.push(parent->addChild(count++));
+    }
+  }
+}
+
+TEST_CASE("Testing deleteSubtreeParallel and compressParallel", "[weight=0]") {
+  GenericTree<int> serialTree;
+  GenericTree<int> parallelTree;
+  // Big enough that the subtrees deleted below are over PARALLEL_MIN_NODES,
+  // so they really are handled in parallel.
+  buildWideTree(serialTree, 20000, 3);
+  buildWideTree(parallelTree, 20000, 3);
+
+  // Delete the same few subtrees from both trees, then compress them.
+  for (int i : {2, 0, 1}) {
+    auto serialRoot = serialTree.getRootPtr();
+    auto parallelRoot = parallelTree.getRootPtr();
+    serialTree.deleteSubtree(serialRoot->childrenPtrs.at(0)->childrenPtrs.at(i));
+    parallelTree.deleteSubtreeParallel(parallelRoot->childrenPtrs.at(0)->childrenPtrs.at(i), 4);
+  }
+  serialTree.compress();
+  parallelTree.compressParallel(4);
+
+  SECTION("Both trees should print the same") {
+    std::stringstream serialOutput;
+    std::stringstream parallelOutput;
+    serialOutput << serialTree;
+    parallelOutput << parallelTree;
+    REQUIRE(serialOutput.str() == parallelOutput.str());
+    REQUIRE(0 == countNullChildrenIterative(parallelTree.getRootPtr()));
+  }
+
+  SECTION("Deleting the whole tree in parallel should reset the root") {
+    parallelTree.deleteSubtreeParallel(parallelTree.getRootPtr(), 4);
+    REQUIRE(nullptr == parallelTree.getRootPtr());
+  }
+
+  SECTION("Small subtrees should be handled without threads") {
+    // A leaf, then a chain that splits into only one part per level.
+    auto root = parallelTree.getRootPtr();
+    auto leaf = root->addChild(-1);
+    parallelTree.deleteSubtreeParallel(leaf, 4);
+    REQUIRE(nullptr == root->childrenPtrs.back());
+    auto chain = root->addChild(-2);
+    for (int i = 0; i < 10; i++) {
+      chain = chain->addChild(-3);
+    }
+    parallelTree.deleteSubtreeParallel(root->childrenPtrs.back(), 4);
+    parallelTree.compressParallel(4);
+    REQUIRE(0 == countNullChildrenIterative(parallelTree.getRootPtr()));
+    GenericTree<int> smallTree(1);
+    smallTree.getRootPtr()->addChild(2);
+    smallTree.compressParallel(4);
+    smallTree.deleteSubtreeParallel(smallTree.getRootPtr(), 4);
+    REQUIRE(nullptr == smallTree.getRootPtr());
+  }
+}
+
+// This is hidden because of the [.] tag.
+// You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: deleteSubtree vs. deleteSubtreeParallel", "[weight=0][.][bench]") {
+
+  constexpr int TREE_SIZE = 2000000;
+  constexpr int BRANCHING = 4;
+
+  std::cout << std::endl << "Deleting a tree of " << TREE_SIZE << " nodes:" << std::endl;
+  {
+    GenericTree<int> tree;
+    buildWideTree(tree, TREE_SIZE, BRANCHING);
+    auto start_time = std::chrono::high_resolution_clock::now();
+    tree.deleteSubtree(tree.getRootPtr());
+    auto stop_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> dur_ms = stop_time - start_time;
+    std::cout << "deleteSubtree: " << dur_ms.count() << "ms" << std::endl;
+  }
+  {
+    GenericTree<int> tree;
+    buildWideTree(tree, TREE_SIZE, BRANCHING);
+    auto start_time = std::chrono::high_resolution_clock::now();
+    tree.deleteSubtreeParallel(tree.getRootPtr());
+    auto stop_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> dur_ms = stop_time - start_time;
+    std::cout << "deleteSubtreeParallel: " << dur_ms.count() << "ms" << std::endl;
+  }
+}
+
+TEST_CASE("Testing the Arena allocation mode", "[weight=0]") {
+  using Allocation = GenericTree<std::string>::Allocation;
+
+  GenericTree<std::string> heapTree("A");
+  GenericTree<std::string> arenaTree("A", Allocation::Arena);
+  REQUIRE(arenaTree.allocation() == Allocation::Arena);
+
+  for (auto tree : {&heapTree, &arenaTree}) {
+    auto A = tree->getRootPtr();
+    A->addChild("B")->addChild("C");
+    auto D = A->addChild("D");
+    auto E = D->addChild("E");
+    E->addChild("F");
+    E->addChild("G")->addChild("H");
+    D->addChild("I");
+    A->addChild("J");
+    auto L = A->addChild("K")->addChild("L");
+    L->addChild("M");
+    tree->deleteSubtree(D);
+    tree->deleteSubtree(L);
+    tree->compress();
+  }
+
+  SECTION("Arena tree should match the heap tree after deletions") {
+    std::stringstream heapOutput;
+    std::stringstream arenaOutput;
+    heapOutput << heapTree;
+    arenaOutput << arenaTree;
+    REQUIRE(heapOutput.str() == arenaOutput.str());
+    REQUIRE(traverseLevels(heapTree) == traverseLevels(arenaTree));
+  }
+
+  SECTION("Arena tree can be cleared and reused") {
+    arenaTree.clear();
+    REQUIRE(nullptr == arenaTree.getRootPtr());
+    auto root = arenaTree.createRoot("X");
+    for (int i = 0; i < 5000; i++) {
+      root = root->addChild(std::to_string(i));
+    }
+    REQUIRE(arenaTree.getRootPtr()->data == "X");
+    REQUIRE(root->data == "4999");
+  }
+}
+
+// This is hidden because of the [.] tag.
+// You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: building and clearing Heap vs. Arena trees", "[weight=0][.][bench]") {
+
+  constexpr int TREE_SIZE = 2000000;
+  constexpr int BRANCHING = 4;
+  using Allocation = GenericTree<int>::Allocation;
+
+  std::cout << std::endl << "Building and clearing a tree of " << TREE_SIZE << " nodes:" << std::endl;
+  for (auto allocation : {Allocation::Heap, Allocation::Arena}) {
+    GenericTree<int> tree(allocation);
+    auto start_time = std::chrono::high_resolution_clock::now();
+    buildWideTree(tree, TREE_SIZE, BRANCHING);
+    auto built_time = std::chrono::high_resolution_clock::now();
+    tree.clear();
+    auto stop_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> build_ms = built_time - start_time;
+    std::chrono::duration<double, std::milli> clear_ms = stop_time - built_time;
+    std::cout << (Allocation::Arena == allocation ? "Arena" : "Heap") << ": build "
+      << build_ms.count() << "ms, clear " << clear_ms.count() << "ms" << std::endl;
+  }
+}
+
+TEST_CASE("Testing lazy levelOrder and preOrder traversals", "[weight=0]") {
+  GenericTree<std::string> tree2("A");
+  auto A = tree2.getRootPtr();
+  A->addChild("B")->addChild("C");
+  auto D = A->addChild("D");
+  auto E = D->addChild("E");
+  E->addChild("F");
+  E->addChild("G")->addChild("H");
+  D->addChild("I");
+  A->addChild("J");
+  auto L = A->addChild("K")->addChild("L");
+  L->addChild("M");
+  tree2.deleteSubtree(D->childrenPtrs.at(1));
+
+  SECTION("levelOrder visits nodes like traverseLevels") {
+    std::vector<std::string> visited;
+    for (auto& data : levelOrder(tree2)) {
+      visited.push_back(data);
+    }
+    REQUIRE(visited == traverseLevels(tree2));
+  }
+
+  SECTION("levelOrder marks the first node of each level") {
+    std::stringstream outstream;
+    auto traversal = levelOrder(tree2);
+    for (auto it = traversal.begin(); it != traversal.end(); ++it) {
+      if (it.startsLevel()) outstream << "| ";
+      outstream << *it << " ";
+    }
+    REQUIRE(outstream.str() == "| A | B D J K | C E L | F G M | H ");
+  }
+
+  SECTION("levelOrder stops at maxDepth") {
+    std::stringstream outstream;
+    for (auto& data : levelOrder(tree2, 1)) {
+      outstream << data << " ";
+    }
+    REQUIRE(outstream.str() == "A B D J K ");
+  }
+
+  SECTION("preOrder visits nodes in the order that Print shows them") {
+    std::stringstream outstream;
+    auto traversal = preOrder(tree2);
+    for (auto it = traversal.begin(); it != traversal.end(); ++it) {
+      outstream << it.depth() << *it << " ";
+    }
+    REQUIRE(outstream.str() == "0A 1B 2C 1D 2E 3F 3G 4H 1J 1K 2L 3M ");
+  }
+
+  SECTION("Traversals work with standard algorithms and can stop early") {
+    auto traversal = levelOrder(tree2);
+    auto found = std::find(traversal.begin(), traversal.end(), std::string("E"));
+    REQUIRE(found != traversal.end());
+    REQUIRE(found.node() == E);
+    // Only L (under K) and E's children F and G are waiting now.
+    REQUIRE(traversal.frontierSize() == 3);
+  }
+}
+
+// A user-supplied aggregate policy without subtract: the largest data
+// item in each subtree. (Null children contribute the smallest int.)
+struct MaxDataAggregate {
+  using value_type = int;
+  static int ofNode(int data) { return data; }
+  static int ofNull() { return std::numeric_limits<int>::min(); }
+  static int combine(int a, int b) { return a > b ? a : b; }
+};
+
+// An aggregate whose value type has a destructor: subtree sizes, kept in
+// a type that counts how many of its values are alive.
+struct CountedValue {
+  static int live;
+  int value;
+  CountedValue(int valueArg = 0) : value(valueArg) { live++; }
+  CountedValue(const CountedValue& other) : value(other.value) { live++; }
+  CountedValue& operator=(const CountedValue& other) = default;
+  ~CountedValue() { live--; }
+};
+int CountedValue::live = 0;
+
+struct CountedSizeAggregate {
+  using value_type = CountedValue;
+  static CountedValue ofNode(int data) { return CountedValue(1); }
+  static CountedValue ofNull() { return CountedValue(0); }
+  static CountedValue combine(const CountedValue& a, const CountedValue& b) { return CountedValue(a.value + b.value); }
+};
+
+TEST_CASE("Testing cached subtree aggregates", "[weight=0]") {
+
+  SECTION("Subtree sizes and null children counts stay correct") {
+    GenericTree<int, SubtreeSizeAggregate> sizeTree(GenericTree<int, SubtreeSizeAggregate>::Allocation::Arena);
+    GenericTree<int, NullChildCountAggregate> nullTree;
+    REQUIRE(sizeTree.aggregate() == 0);
+    REQUIRE(nullTree.aggregate() == 1);
+
+    auto sizeRoot = sizeTree.createRoot(0);
+    auto nullRoot = nullTree.createRoot(0);
+    for (int i = 1; i <= 3; i++) {
+      auto sizeChild = sizeRoot->addChild(i);
+      auto nullChild = nullRoot->addChild(i);
+      for (int j = 0; j < 4; j++) {
+        sizeChild->addChild(10 * i + j);
+        nullChild->addChild(10 * i + j);
+      }
+    }
+    REQUIRE(sizeTree.aggregate() == 16);
+    REQUIRE(nullTree.aggregate() == 0);
+
+    sizeTree.deleteSubtree(sizeRoot->childrenPtrs.at(1)->childrenPtrs.at(2));
+    nullTree.deleteSubtree(nullRoot->childrenPtrs.at(1)->childrenPtrs.at(2));
+    sizeTree.deleteSubtreeParallel(sizeRoot->childrenPtrs.at(2), 2);
+    nullTree.deleteSubtreeParallel(nullRoot->childrenPtrs.at(2), 2);
+    REQUIRE(sizeTree.aggregate() == 10);
+    REQUIRE(sizeTree.subtreeAggregate(sizeRoot->childrenPtrs.at(1)) == 4);
+    REQUIRE(nullTree.aggregate() == countNullChildrenIterative(nullRoot));
+    REQUIRE(nullTree.aggregate() == 2);
+
+    nullTree.compress();
+    REQUIRE(nullTree.aggregate() == 0);
+  }
+
+  SECTION("A user-supplied monoid is maintained by recomputation") {
+    GenericTree<int, MaxDataAggregate> tree(5);
+    auto root = tree.getRootPtr();
+    auto left = root->addChild(3);
+    left->addChild(42);
+    root->addChild(7)->addChild(8);
+    REQUIRE(tree.aggregate() == 42);
+    REQUIRE(tree.subtreeAggregate(root->childrenPtrs.at(1)) == 8);
+
+    tree.deleteSubtree(left->childrenPtrs.at(0));
+    REQUIRE(tree.aggregate() == 8);
+
+    root->data = 100;
+    tree.refreshAggregates();
+    REQUIRE(tree.aggregate() == 100);
+
+    tree.deleteSubtree(left);
+    tree.compressParallel(2);
+    REQUIRE(tree.subtreeAggregate(root->childrenPtrs.at(0)) == 8);
+  }
+
+  SECTION("Aggregate values are destroyed along with an Arena tree") {
+    REQUIRE(CountedValue::live == 0);
+    {
+      // int data doesn't need a destructor, but the aggregates do.
+      GenericTree<int, CountedSizeAggregate> tree(GenericTree<int, CountedSizeAggregate>::Allocation::Arena);
+      auto root = tree.createRoot(0);
+      for (int i = 1; i <= 10; i++) {
+        root->addChild(i)->addChild(10 * i);
+      }
+      REQUIRE(tree.aggregate().value == 21);
+      REQUIRE(CountedValue::live > 0);
+    }
+    REQUIRE(CountedValue::live == 0);
+  }
+}
+
+TEST_CASE("Testing tree images", "[weight=0]") {
+  GenericTree<int> tree(1);
+  auto root = tree.getRootPtr();
+  auto n2 = root->addChild(2);
+  auto n3 = root->addChild(3);
+  root->addChild(4);
+  n2->addChild(5);
+  n2->addChild(6)->addChild(7);
+  n3->addChild(8);
+  // Leaves a null pointer among the root's children, which is skipped.
+  tree.deleteSubtree(n3);
+
+  std::vector<int> expectedPreOrder;
+  for (int data : preOrder(tree)) expectedPreOrder.push_back(data);
+
+  std::stringstream buffer;
+  writeTreeImage(tree, buffer);
+  const std::string image = buffer.str();
+
+  SECTION("A view reads the tree in place") {
+    TreeImageView<int> view(image.data(), image.size());
+    REQUIRE(view.size() == expectedPreOrder.size());
+    REQUIRE(std::vector<int>(view.dataArray(), view.dataArray() + view.size()) == expectedPreOrder);
+    REQUIRE(view.childCount(0) == 2);
+    REQUIRE(view.subtreeSize(0) == 6);
+
+    std::vector<int> rootChildren;
+    for (auto child : view.children(0)) rootChildren.push_back(view.data(child));
+    REQUIRE(rootChildren == std::vector<int>{2, 4});
+
+    std::vector<int> n2Children;
+    for (auto child : view.children(1)) n2Children.push_back(view.data(child));
+    REQUIRE(n2Children == std::vector<int>{5, 6});
+  }
+
+  SECTION("A tree can be rebuilt from its image") {
+    TreeImageView<int> view(image.data(), image.size());
+    GenericTree<int> rebuilt(999);
+    buildTreeFromImage(view, rebuilt);
+    std::stringstream original, copy;
+    tree.compress();
+    tree.Print(original);
+    rebuilt.Print(copy);
+    REQUIRE(original.str() == copy.str());
+  }
+
+  SECTION("Invalid images are rejected") {
+    REQUIRE_THROWS_AS(TreeImageView<double>(image.data(), image.size()), std::runtime_error);
+    REQUIRE_THROWS_AS(TreeImageView<int>(image.data(), image.size() - 1), std::runtime_error);
+    std::string corrupted = image;
+    corrupted[0] = 'X';
+    REQUIRE_THROWS_AS(TreeImageView<int>(corrupted.data(), corrupted.size()), std::runtime_error);
+
+    // Child counts and subtree sizes that don't describe a tree.
+    const std::size_t nodeCount = expectedPreOrder.size();
+    auto setCount = [&](std::string& bytes, std::size_t index, std::uint32_t value) {
+      std::memcpy(&bytes[sizeof(TreeImageHeader) + index * sizeof(std::uint32_t)], &value, sizeof(value));
+    };
+    const std::vector<std::pair<std::size_t, std::uint32_t>> corruptions = {
+      {0, 0},                 // the root has no children
+      {0, 100},               // the root has too many children
+      {1, 0},                 // a child count that doesn't add up
+      {nodeCount, 1},         // the root's subtree isn't the whole tree
+      {nodeCount + 1, 0},     // an empty subtree
+      {nodeCount + 1, 1000},  // a subtree past the end of the image
+    };
+    for (const auto& corruption : corruptions) {
+      std::string badCounts = image;
+      setCount(badCounts, corruption.first, corruption.second);
+      REQUIRE_THROWS_AS(TreeImageView<int>(badCounts.data(), badCounts.size()), std::runtime_error);
+    }
+  }
+
+  SECTION("An image file can be memory-mapped") {
+    const std::string filename = "week3_test_tree.img";
+    saveTreeImage(tree, filename);
+    {
+      MappedTreeImage<int> mapped(filename);
+      REQUIRE(std::vector<int>(mapped.view().dataArray(), mapped.view().dataArray() + mapped.view().size()) == expectedPreOrder);
+    }
+    std::remove(filename.c_str());
+    REQUIRE_THROWS_AS(MappedTreeImage<int>(filename), std::runtime_error);
+  }
+
+  SECTION("An empty tree makes an empty image") {
+    GenericTree<int> emptyTree;
+    std::stringstream emptyBuffer;
+    writeTreeImage(emptyTree, emptyBuffer);
+    const std::string emptyImage = emptyBuffer.str();
+    TreeImageView<int> view(emptyImage.data(), emptyImage.size());
+    REQUIRE(view.empty());
+  }
+}
+
+// This is hidden because of the [.] tag.
+// You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: rebuilding a tree vs. mapping its image", "[weight=0][.][bench]") {
+
+  constexpr int TREE_SIZE = 2000000;
+  constexpr int BRANCHING = 4;
+  const std::string filename = "week3_bench_tree.img";
+
+  GenericTree<int> tree;
+  buildWideTree(tree, TREE_SIZE, BRANCHING);
+  saveTreeImage(tree, filename);
+
+  std::cout << std::endl << "Loading a tree of " << TREE_SIZE << " nodes and summing its data:" << std::endl;
+  {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    MappedTreeImage<int> mapped(filename);
+    GenericTree<int> rebuilt;
+    buildTreeFromImage(mapped.view(), rebuilt);
+    long long sum = 0;
+    for (int data : preOrder(rebuilt)) sum += data;
+    auto stop_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> dur_ms = stop_time - start_time;
+    if (sum) std::cout << "Rebuild GenericTree: " << dur_ms.count() << "ms" << std::endl;
+  }
+  {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    MappedTreeImage<int> mapped(filename);
+    const auto& view = mapped.view();
+    long long sum = 0;
+    for (std::size_t i = 0; i < view.size(); i++) sum += view.data(i);
+    auto stop_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> dur_ms = stop_time - start_time;
+    if (sum) std::cout << "Read mapped image: " << dur_ms.count() << "ms" << std::endl;
+  }
+
+  std::remove(filename.c_str());
+}
+
+TEST_CASE("Testing Print output format", "[weight=0]") {
+  GenericTree<std::string> tree("A");
+  auto b = tree.getRootPtr()->addChild("B");
+  b->addChild("C");
+  b->childrenPtrs.push_back(nullptr);
+  tree.getRootPtr()->addChild("D")->addChild("E");
+
+  std::stringstream output;
+  tree.Print(output);
+  const std::string expected =
+    "A\n"
+    "|\n"
+    "|_ B\n"
+    "|  |\n"
+    "|  |_ C\n"
+    "|  |\n"
+    "|  |_ [null]\n"
+    "|\n"
+    "|_ D\n"
+    "   |\n"
+    "   |_ E\n";
+  REQUIRE(output.str() == expected);
+
+  std::stringstream emptyOutput;
+  GenericTree<std::string>().Print(emptyOutput);
+  REQUIRE(emptyOutput.str() == "[empty tree]\n");
+}
+
+// This is hidden because of the [.] tag.
+// You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: Print a large tree", "[weight=0][.][bench]") {
+
+  constexpr int TREE_SIZE = 1000000;
+  constexpr int BRANCHING = 4;
+
+  GenericTree<int> tree;
+  buildWideTree(tree, TREE_SIZE, BRANCHING);
+
+  std::stringstream output;
+  auto start_time = std::chrono::high_resolution_clock::now();
+  tree.Print(output);
+  auto stop_time = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::milli> dur_ms = stop_time - start_time;
+  std::cout << std::endl << "Print of " << TREE_SIZE << " nodes (" << output.str().size()
+    << " bytes): " << dur_ms.count() << "ms" << std::endl;
+}
@@ -0,0 +1,263 @@
+/**
+ * @file FlatStringIntMap.cpp
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * An open-addressing hash table from strings to ints.
+ *
+**/
+
+#include <functional> // for std::hash
+#include <stdexcept> // for std::out_of_range, std::length_error
+#include <utility> // for std::move, std::forward
+
+#ifdef __SSE2__
+#include <emmintrin.h> // for SSE2 intrinsics
+#endif
+
+#include "FlatStringIntMap.h"
+
+// In some versions of C++ we have to redeclare constant static members
+// at global scope like this to ensure that the linker doesn't give an error.
+constexpr std::int8_t FlatStringIntMap::CONTROL_EMPTY;
+constexpr std::int8_t FlatStringIntMap::CONTROL_DELETED;
+constexpr std::size_t FlatStringIntMap::GROUP_SIZE;
+constexpr std::uint32_t FlatStringIntMap::NOT_FOUND;
+
+// The low 7 bits of the hash go in the control byte, and the rest of the
+// bits choose the group.
+static inline std::int8_t hashTag(std::size_t hash) {
+  return static_cast<std::int8_t>(hash & 0x7F);
+}
+static inline std::size_t hashGroup(std::size_t hash) {
+  return hash >> 7;
+}
+
+// Returns a bit mask with bit i set if control[i] == value, for the 16
+// control bytes of a group.
+static inline unsigned int matchGroup(const std::int8_t* control, std::int8_t value) {
+#ifdef __SSE2__
+  const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+  return static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(value))));
+#else
+  unsigned int mask = 0;
+  for (unsigned int i = 0; i < 16; i++) {
+    if (control[i] == value) mask |= (1u << i);
+  }
+  return mask;
+#endif
+}
+
+// Returns the index of the lowest set bit of a nonzero mask.
+static inline unsigned int lowestBit(unsigned int mask) {
+  return static_cast<unsigned int>(__builtin_ctz(mask));
+}
+
+FlatStringIntMap::FlatStringIntMap() : deletedCount_(0) {}
+
+FlatStringIntMap::FlatStringIntMap(std::initializer_list<value_type> entries) : FlatStringIntMap() {
+  reserve(entries.size());
+  for (const value_type& entry : entries) {
+    // Like std::unordered_map, keep the first value given for a duplicate key.
+    if (NOT_FOUND == findEntry(entry.first)) {
+      findOrInsert(entry.first) = entry.second;
+    }
+  }
+}
+
+int& FlatStringIntMap::operator[](const std::string& key) {
+  return findOrInsert(key);
+}
+
+int& FlatStringIntMap::operator[](std::string&& key) {
+  return findOrInsert(std::move(key));
+}
+
+int& FlatStringIntMap::at(const std::string& key) {
+  std::uint32_t entryIndex = findEntry(key);
+  if (NOT_FOUND == entryIndex) {
+    throw std::out_of_range("FlatStringIntMap::at: key not found");
+  }
+  return entries_[entryIndex].second;
+}
+
+const int& FlatStringIntMap::at(const std::string& key) const {
+  std::uint32_t entryIndex = findEntry(key);
+  if (NOT_FOUND == entryIndex) {
+    throw std::out_of_range("FlatStringIntMap::at: key not found");
+  }
+  return entries_[entryIndex].second;
+}
+
+FlatStringIntMap::const_iterator FlatStringIntMap::find(const std::string& key) const {
+  std::uint32_t entryIndex = findEntry(key);
+  return (NOT_FOUND == entryIndex) ? entries_.end() : entries_.begin() + entryIndex;
+}
+
+std::uint32_t FlatStringIntMap::findEntry(const std::string& key) const {
+  if (entries_.empty()) return NOT_FOUND;
+  return findEntry(key, std::hash<std::string>()(key));
+}
+
+std::uint32_t FlatStringIntMap::findEntry(const std::string& key, std::size_t hash) const {
+  if (control_.empty()) return NOT_FOUND;
+
+  const std::int8_t tag = hashTag(hash);
+  const std::size_t groupMask = control_.size() / GROUP_SIZE - 1;
+  std::size_t group = hashGroup(hash) & groupMask;
+
+  // Visit groups in "triangular" order: +1, +2, +3, ... groups away. With a
+  // power-of-two number of groups, this visits every group exactly once.
+  for (std::size_t step = 1; ; step++) {
+    const std::int8_t* groupControl = control_.data() + group * GROUP_SIZE;
+    for (unsigned int matches = matchGroup(groupControl, tag); matches; matches &= matches - 1) {
+      std::size_t slot = group * GROUP_SIZE + lowestBit(matches);
+      std::uint32_t entryIndex = slots_[slot];
+      if (entryHashes_[entryIndex] == hash && entries_[entryIndex].first == key) {
+        return entryIndex;
+      }
+    }
+    if (matchGroup(groupControl, CONTROL_EMPTY)) {
+      return NOT_FOUND;
+    }
+    if (step > groupMask) {
+      // Every group is full of other keys or deleted slots.
+      return NOT_FOUND;
+    }
+    group = (group + step) & groupMask;
+  }
+}
+
+std::size_t FlatStringIntMap::findFreeSlot(std::size_t hash) const {
+  const std::size_t groupMask = control_.size() / GROUP_SIZE - 1;
+  std::size_t group = hashGroup(hash) & groupMask;
+  for (std::size_t step = 1; ; step++) {
+    const std::int8_t* groupControl = control_.data() + group * GROUP_SIZE;
+    unsigned int freeSlots = matchGroup(groupControl, CONTROL_EMPTY) | matchGroup(groupControl, CONTROL_DELETED);
+    if (freeSlots) {
+      return group * GROUP_SIZE + lowestBit(freeSlots);
+    }
+    // The table is never allowed to fill up, so this loop always finishes.
+    group = (group + step) & groupMask;
+  }
+}
+
+std::size_t FlatStringIntMap::findSlotOfEntry(std::uint32_t entryIndex) const {
+  const std::size_t hash = entryHashes_[entryIndex];
+  const std::int8_t tag = hashTag(hash);
+  const std::size_t groupMask = control_.size() / GROUP_SIZE - 1;
+  std::size_t group = hashGroup(hash) & groupMask;
+  for (std::size_t step = 1; ; step++) {
+    const std::int8_t* groupControl = control_.data() + group * GROUP_SIZE;
+    for (unsigned int matches = matchGroup(groupControl, tag); matches; matches &= matches - 1) {
+      std::size_t slot = group * GROUP_SIZE + lowestBit(matches);
+      if (slots_[slot] == entryIndex) {
+        return slot;
+      }
+    }
+    // The entry is known to be in the table, so this loop always finishes.
+    group = (group + step) & groupMask;
+  }
+}
+
+template <typename Key>
+int& FlatStringIntMap::findOrInsert(Key&& key) {
+  const std::size_t hash = std::hash<std::string>()(key);
+  std::uint32_t entryIndex = findEntry(key, hash);
+  if (NOT_FOUND != entryIndex) {
+    return entries_[entryIndex].second;
+  }
+
+  if (entries_.size() >= NOT_FOUND - 1) {
+    throw std::length_error("FlatStringIntMap is full");
+  }
+
+  // Grow before inserting if the new entry would make the table more than
+  // 7/8 full (counting deleted slots, since they also lengthen searches).
+  if ((entries_.size() + deletedCount_ + 1) * 8 > control_.size() * 7) {
+    makeRoomFor(entries_.size() + 1);
+  }
+
+  std::size_t slot = findFreeSlot(hash);
+  if (CONTROL_DELETED == control_[slot]) {
+    deletedCount_--;
+  }
+  entryIndex = static_cast<std::uint32_t>(entries_.size());
+  entries_.emplace_back(std::forward<Key>(key), 0);
+  entryHashes_.push_back(hash);
+  control_[slot] = hashTag(hash);
+  slots_[slot] = entryIndex;
+  return entries_.back().second;
+}
+
+FlatStringIntMap::size_type FlatStringIntMap::erase(const std::string& key) {
+  std::uint32_t entryIndex = findEntry(key);
+  if (NOT_FOUND == entryIndex) return 0;
+
+  // Mark the slot as deleted rather than empty, so that searches for other
+  // keys that passed through this group keep going.
+  std::size_t slot = findSlotOfEntry(entryIndex);
+  control_[slot] = CONTROL_DELETED;
+  deletedCount_++;
+
+  // Keep the entries vector dense by moving the last entry into the gap.
+  std::uint32_t lastIndex = static_cast<std::uint32_t>(entries_.size() - 1);
+  if (entryIndex != lastIndex) {
+    slots_[findSlotOfEntry(lastIndex)] = entryIndex;
+    entries_[entryIndex] = std::move(entries_[lastIndex]);
+    entryHashes_[entryIndex] = entryHashes_[lastIndex];
+  }
+  entries_.pop_back();
+  entryHashes_.pop_back();
+  return 1;
+}
+
+void FlatStringIntMap::clear() {
+  entries_.clear();
+  entryHashes_.clear();
+  control_.assign(control_.size(), CONTROL_EMPTY);
+  deletedCount_ = 0;
+}
+
+void FlatStringIntMap::reserve(size_type entryCount) {
+  entries_.reserve(entryCount);
+  entryHashes_.reserve(entryCount);
+  makeRoomFor(entryCount);
+}
+
+void FlatStringIntMap::makeRoomFor(size_type entryCount) {
+  // Choose the smallest power-of-two size that keeps the table at most 7/8 full.
+  std::size_t slotCount = GROUP_SIZE;
+  while (entryCount * 8 > slotCount * 7) {
+    slotCount *= 2;
+  }
+  if (slotCount > control_.size()) {
+    rehash(slotCount);
+  }
+  else if ((entryCount + deletedCount_) * 8 > control_.size() * 7) {
+    // There are enough slots, but too many of them are marked deleted.
+    // Rebuilding at the same size clears those out.
+    rehash(control_.size());
+  }
+}
+
+void FlatStringIntMap::rehash(std::size_t slotCount) {
+  control_.assign(slotCount, CONTROL_EMPTY);
+  slots_.assign(slotCount, 0);
+  deletedCount_ = 0;
+  for (std::uint32_t entryIndex = 0; entryIndex < entries_.size(); entryIndex++) {
+    std::size_t slot = findFreeSlot(entryHashes_[entryIndex]);
+    control_[slot] = hashTag(entryHashes_[entryIndex]);
+    slots_[slot] = entryIndex;
+  }
+}
+
+bool FlatStringIntMap::operator==(const FlatStringIntMap& other) const {
+  if (size() != other.size()) return false;
+  for (std::uint32_t i = 0; i < entries_.size(); i++) {
+    std::uint32_t otherIndex = other.findEntry(entries_[i].first, entryHashes_[i]);
+    if (NOT_FOUND == otherIndex || other.entries_[otherIndex].second != entries_[i].second) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file FlatStringIntMap.h
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * An open-addressing hash table from strings to ints.
+ *
+**/
+
+#pragma once
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::int8_t, std::uint32_t
+#include <initializer_list> // for std::initializer_list
+#include <string> // for std::string
+#include <utility> // for std::pair
+#include <vector> // for std::vector
+
+// -------------------------------------------------------------------
+// FlatStringIntMap class
+// -------------------------------------------------------------------
+// std::unordered_map uses "separate chaining": each bucket is a linked list,
+// and every entry is a separately allocated node. Looking up a key means
+// following pointers to places all over memory.
+//
+// This class is a hash table that uses "open addressing" instead, in the
+// style of Google's SwissTable. There are no linked lists:
+//
+// - The entries (key and value pairs) are stored together in one vector,
+//   in the order they were inserted. Short strings (up to 15 characters
+//   with the GNU library) are kept inside the std::string object itself,
+//   so for most words the key's characters are right there in the vector.
+// - The hash table itself is an array of slots, where each slot holds the
+//   index of an entry. Alongside the slots is an array of one-byte "control"
+//   values: a control byte says whether its slot is empty, deleted, or full,
+//   and for full slots it also stores 7 bits of the key's hash.
+// - The slots are divided into groups of 16. A lookup goes to the group
+//   that the key's hash chooses and compares all 16 control bytes at once
+//   (with an SSE2 instruction, where available) against the key's 7 hash
+//   bits. Only the few slots that match need their keys compared. If the
+//   group has an empty slot and the key wasn't found, the key isn't in the
+//   table; otherwise, the search moves on to another group.
+//
+// The table is never more than 7/8 full, so most lookups only examine a
+// single group.
+//
+// This supports the parts of the std::unordered_map interface that the
+// word counting code uses, so StringIntMap can be switched to this type
+// (see UnorderedMapCommon.h). One difference is that iterating over the
+// map only gives read-only access to the entries; use operator[] or at()
+// to change a value.
+
+class FlatStringIntMap {
+public:
+  using key_type = std::string;
+  using mapped_type = int;
+  using value_type = std::pair<std::string, int>;
+  using size_type = std::size_t;
+  using const_iterator = std::vector<value_type>::const_iterator;
+  using iterator = const_iterator;
+
+  FlatStringIntMap();
+  FlatStringIntMap(std::initializer_list<value_type> entries);
+
+  // Look up a key, inserting it with the value 0 if it isn't found.
+  int& operator[](const std::string& key);
+  int& operator[](std::string&& key);
+
+  // Look up a key that must exist. Throws std::out_of_range otherwise.
+  int& at(const std::string& key);
+  const int& at(const std::string& key) const;
+
+  // Returns 1 if the key is in the map and 0 otherwise.
+  size_type count(const std::string& key) const { return (NOT_FOUND != findEntry(key)) ? 1 : 0; }
+
+  // Returns an iterator to the key's entry, or end() if it isn't found.
+  const_iterator find(const std::string& key) const;
+
+  // Remove a key from the map. Returns the number of entries removed (0 or 1).
+  // The last entry is moved into the removed entry's place, so this changes
+  // the iteration order.
+  size_type erase(const std::string& key);
+
+  size_type size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+  void clear();
+
+  // Make room for at least the given number of entries without rehashing.
+  void reserve(size_type entryCount);
+
+  // Number of slots in the hash table, and the fraction of them in use.
+  size_type bucket_count() const { return control_.size(); }
+  float load_factor() const {
+    return control_.empty() ? 0.0f : static_cast<float>(size()) / bucket_count();
+  }
+
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+
+  // Two maps are equal if they have the same keys with the same values,
+  // in any order.
+  bool operator==(const FlatStringIntMap& other) const;
+  bool operator!=(const FlatStringIntMap& other) const { return !(*this == other); }
+
+private:
+  // Control byte values. Full slots store the low 7 bits of the hash,
+  // which is a value from 0 to 127, so these special values are negative.
+  static constexpr std::int8_t CONTROL_EMPTY = -128;
+  static constexpr std::int8_t CONTROL_DELETED = -2;
+  static constexpr std::size_t GROUP_SIZE = 16;
+  static constexpr std::uint32_t NOT_FOUND = 0xFFFFFFFFu;
+
+  std::vector<value_type> entries_;
+  // The full hash of each entry, so rehashing doesn't need to hash the keys again.
+  std::vector<std::size_t> entryHashes_;
+  std::vector<std::int8_t> control_;
+  std::vector<std::uint32_t> slots_;
+  // Number of slots marked CONTROL_DELETED.
+  size_type deletedCount_;
+
+  // Index of the entry for the key, or NOT_FOUND.
+  std::uint32_t findEntry(const std::string& key) const;
+  std::uint32_t findEntry(const std::string& key, std::size_t hash) const;
+
+  // Find the key's entry, or add a new entry for it with the value 0.
+  template <typename Key>
+  int& findOrInsert(Key&& key);
+
+  // Index of the slot that refers to the given entry.
+  std::size_t findSlotOfEntry(std::uint32_t entryIndex) const;
+
+  // Index of the first empty or deleted slot for a hash.
+  std::size_t findFreeSlot(std::size_t hash) const;
+
+  // Grow or clean up the table so that it can hold the given number of
+  // entries while staying at most 7/8 full.
+  void makeRoomFor(size_type entryCount);
+
+  // Rebuild the table with the given number of slots (a power of two,
+  // and at least GROUP_SIZE).
+  void rehash(std::size_t slotCount);
+};
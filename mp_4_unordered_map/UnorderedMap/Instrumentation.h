@@ -0,0 +1,350 @@
+/**
+ * @file Instrumentation.h
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * Timers, time limits, and timing reports for measuring the code.
+ *
+**/
+
+#pragma once
+
+#include <algorithm> // for std::min, std::max
+#include <atomic> // for std::atomic
+#include <chrono> // for std::chrono
+#include <cstdint> // for std::uint64_t
+#include <iomanip> // for std::setw, std::setprecision
+#include <iostream> // for std::cerr
+#include <limits> // for std::numeric_limits
+#include <map> // for std::map
+#include <memory> // for std::unique_ptr
+#include <mutex> // for std::mutex, std::lock_guard
+#include <ostream> // for std::ostream
+#include <string> // for std::string
+
+#include "UnorderedMapCommon.h" // for timeUnit, getTimeNow, getMilliDuration, TooSlowException
+
+// UnorderedMapCommon.h gives us getTimeNow and getMilliDuration, and the
+// palindrome functions use them to check a time limit on every call. This
+// file builds on those to make measuring any part of the code easy and
+// consistent:
+//
+// - DeadlineChecker: a time limit that only reads the clock every so often.
+// - TimingHistogram: a summary of many measured durations.
+// - TimingSite: the durations recorded under one label, which any number
+//   of threads can add to at once without taking a lock.
+// - TimingRegistry: the sites by label, shared by the whole program, with
+//   a report that can be printed at any time or automatically at exit.
+// - ScopedTimer, and the INSTRUMENT_SCOPE macro: time a block of code
+//   from where the timer is created until the end of the block.
+//
+// This header is meant to be usable from any of the MPs, but each MP is
+// built and submitted on its own, with its own Makefile and its own copy
+// of the uiuc support files, so an MP that wants it should take a copy
+// rather than include it from here. (The LINKEDLIST_INSTRUMENT counters in
+// mp_2 count list operations rather than time them, so they stay as they
+// are.)
+
+// -------------------------------------------------------------------
+// DeadlineChecker class
+// -------------------------------------------------------------------
+// Reading the clock is cheap, but not free, and a tight loop can do a lot
+// of work in the time it takes. A DeadlineChecker counts calls to check()
+// and only reads the clock on every checkInterval-th one, so it can be
+// called on every iteration. When the time limit has passed, check()
+// throws TooSlowException, just like the palindrome functions.
+class DeadlineChecker {
+public:
+  DeadlineChecker(timeUnit startTime, double maxDuration, unsigned int checkInterval=1024)
+    : startTime_(startTime), maxDuration_(maxDuration), checkInterval_(std::max(1u, checkInterval)),
+      callsUntilCheck_(checkInterval_) {}
+
+  void check() {
+    if (--callsUntilCheck_) return;
+    callsUntilCheck_ = checkInterval_;
+    if (expired()) {
+      throw TooSlowException("taking too long");
+    }
+  }
+
+  // Whether the time limit has passed (always reads the clock).
+  bool expired() const { return getMilliDuration(startTime_, getTimeNow()) > maxDuration_; }
+
+private:
+  timeUnit startTime_;
+  double maxDuration_;
+  unsigned int checkInterval_;
+  unsigned int callsUntilCheck_;
+};
+
+// -------------------------------------------------------------------
+// TimingHistogram class
+// -------------------------------------------------------------------
+// Keeps the number, total, minimum and maximum of a series of durations,
+// and counts them in buckets by powers of two: bucket i counts durations
+// from 2^i up to 2^(i+1) nanoseconds. That's enough to estimate
+// percentiles (to within a factor of two) without storing every duration.
+class TimingHistogram {
+public:
+  static constexpr int BUCKET_COUNT = 64;
+
+  TimingHistogram() : count_(0), totalNanoseconds_(0), minNanoseconds_(0), maxNanoseconds_(0), buckets_() {}
+
+  void record(std::uint64_t nanoseconds) {
+    minNanoseconds_ = count_ ? std::min(minNanoseconds_, nanoseconds) : nanoseconds;
+    maxNanoseconds_ = count_ ? std::max(maxNanoseconds_, nanoseconds) : nanoseconds;
+    count_++;
+    totalNanoseconds_ += nanoseconds;
+    buckets_[bucketOf(nanoseconds)]++;
+  }
+
+  std::uint64_t count() const { return count_; }
+  std::uint64_t totalNanoseconds() const { return totalNanoseconds_; }
+  std::uint64_t minNanoseconds() const { return minNanoseconds_; }
+  std::uint64_t maxNanoseconds() const { return maxNanoseconds_; }
+  double meanNanoseconds() const { return count_ ? static_cast<double>(totalNanoseconds_) / count_ : 0.0; }
+  std::uint64_t bucketCount(int bucket) const { return buckets_[bucket]; }
+
+  // An upper bound for the given fraction (such as 0.99) of the durations:
+  // the top of the bucket where that fraction is reached, but no more than
+  // the maximum.
+  std::uint64_t percentileNanoseconds(double fraction) const {
+    const double wanted = fraction * count_;
+    std::uint64_t seen = 0;
+    for (int bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+      seen += buckets_[bucket];
+      if (seen > 0 && seen >= wanted) {
+        const std::uint64_t bucketTop = (bucket >= 63) ? maxNanoseconds_ : (std::uint64_t(2) << bucket) - 1;
+        return std::min(bucketTop, maxNanoseconds_);
+      }
+    }
+    return maxNanoseconds_;
+  }
+
+  static int bucketOf(std::uint64_t nanoseconds) {
+    return nanoseconds ? 63 - __builtin_clzll(nanoseconds) : 0;
+  }
+
+private:
+  friend class TimingSite;
+
+  std::uint64_t count_;
+  std::uint64_t totalNanoseconds_;
+  std::uint64_t minNanoseconds_;
+  std::uint64_t maxNanoseconds_;
+  std::uint64_t buckets_[BUCKET_COUNT];
+};
+
+// -------------------------------------------------------------------
+// TimingSite class
+// -------------------------------------------------------------------
+// The same summary as a TimingHistogram, for one label, but kept in atomic
+// counters so that record() never takes a lock or allocates. Each counter
+// is updated on its own, so a snapshot taken while other threads are
+// recording may be off by the durations still being added.
+class TimingSite {
+public:
+  explicit TimingSite(const std::string& label) : label_(label) { clear(); }
+
+  TimingSite(const TimingSite& other) = delete;
+  TimingSite& operator=(const TimingSite& other) = delete;
+
+  const std::string& label() const { return label_; }
+
+  void record(std::uint64_t nanoseconds) {
+    count_.fetch_add(1, std::memory_order_relaxed);
+    totalNanoseconds_.fetch_add(nanoseconds, std::memory_order_relaxed);
+    buckets_[TimingHistogram::bucketOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    std::uint64_t oldMin = minNanoseconds_.load(std::memory_order_relaxed);
+    while (nanoseconds < oldMin && !minNanoseconds_.compare_exchange_weak(oldMin, nanoseconds, std::memory_order_relaxed)) {}
+    std::uint64_t oldMax = maxNanoseconds_.load(std::memory_order_relaxed);
+    while (nanoseconds > oldMax && !maxNanoseconds_.compare_exchange_weak(oldMax, nanoseconds, std::memory_order_relaxed)) {}
+  }
+
+  TimingHistogram snapshot() const {
+    TimingHistogram histogram;
+    histogram.count_ = count_.load(std::memory_order_relaxed);
+    if (histogram.count_) {
+      histogram.totalNanoseconds_ = totalNanoseconds_.load(std::memory_order_relaxed);
+      histogram.minNanoseconds_ = minNanoseconds_.load(std::memory_order_relaxed);
+      histogram.maxNanoseconds_ = maxNanoseconds_.load(std::memory_order_relaxed);
+      for (int bucket = 0; bucket < TimingHistogram::BUCKET_COUNT; bucket++) {
+        histogram.buckets_[bucket] = buckets_[bucket].load(std::memory_order_relaxed);
+      }
+    }
+    return histogram;
+  }
+
+  void clear() {
+    count_ = 0;
+    totalNanoseconds_ = 0;
+    minNanoseconds_ = std::numeric_limits<std::uint64_t>::max();
+    maxNanoseconds_ = 0;
+    for (auto& bucket : buckets_) {
+      bucket = 0;
+    }
+  }
+
+private:
+  const std::string label_;
+  std::atomic<std::uint64_t> count_;
+  std::atomic<std::uint64_t> totalNanoseconds_;
+  std::atomic<std::uint64_t> minNanoseconds_;
+  std::atomic<std::uint64_t> maxNanoseconds_;
+  std::atomic<std::uint64_t> buckets_[TimingHistogram::BUCKET_COUNT];
+};
+
+// -------------------------------------------------------------------
+// TimingRegistry class
+// -------------------------------------------------------------------
+// A set of timing sites by label. Looking up a site takes a lock, but that
+// only has to happen once per place in the code that records timings (see
+// INSTRUMENT_SCOPE); after that, recording goes straight to the site.
+// Sites are never removed, so a reference to one stays valid as long as
+// the registry does. Normally the whole program shares one registry,
+// TimingRegistry::global().
+class TimingRegistry {
+public:
+  explicit TimingRegistry(bool reportAtExit=false) : reportAtExit_(reportAtExit) {}
+
+  // Print the report when the registry is destroyed (for the global
+  // registry, that's when the program exits), if anything was recorded.
+  ~TimingRegistry() {
+    if (reportAtExit_ && hasRecordings()) {
+      report(std::cerr);
+    }
+  }
+
+  TimingRegistry(const TimingRegistry& other) = delete;
+  TimingRegistry& operator=(const TimingRegistry& other) = delete;
+
+  // The registry used by ScopedTimer and INSTRUMENT_SCOPE by default. It
+  // prints its report at exit if ENABLE_INSTRUMENTATION was defined when
+  // compiling (for example with "make CS400=-DENABLE_INSTRUMENTATION").
+  static TimingRegistry& global() {
+#ifdef ENABLE_INSTRUMENTATION
+    static TimingRegistry registry(true);
+#else
+    static TimingRegistry registry(false);
+#endif
+    return registry;
+  }
+
+  // The site for a label, created the first time it's asked for.
+  TimingSite& site(const std::string& label) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<TimingSite>& found = sites_[label];
+    if (!found) {
+      found.reset(new TimingSite(label));
+    }
+    return *found;
+  }
+
+  void record(const std::string& label, std::uint64_t nanoseconds) {
+    site(label).record(nanoseconds);
+  }
+
+  // A copy of the histogram for a label (empty if nothing was recorded).
+  TimingHistogram histogram(const std::string& label) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = sites_.find(label);
+    return (found == sites_.end()) ? TimingHistogram() : found->second->snapshot();
+  }
+
+  // Forget everything recorded so far. (The sites themselves stay, since
+  // INSTRUMENT_SCOPE keeps references to them.)
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : sites_) {
+      entry.second->clear();
+    }
+  }
+
+  void setReportAtExit(bool reportAtExit) { reportAtExit_ = reportAtExit; }
+
+  // Print a table with one row per label that has recordings, in
+  // alphabetical order.
+  void report(std::ostream& os) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto oldFlags = os.flags();
+    const auto oldPrecision = os.precision();
+    os << std::left << std::setw(32) << "label" << std::right
+      << std::setw(10) << "calls" << std::setw(12) << "total ms" << std::setw(12) << "mean us"
+      << std::setw(12) << "min us" << std::setw(12) << "p50 us" << std::setw(12) << "p99 us"
+      << std::setw(12) << "max us" << "\n";
+    os << std::fixed << std::setprecision(3);
+    for (const auto& entry : sites_) {
+      const TimingHistogram h = entry.second->snapshot();
+      if (!h.count()) continue;
+      os << std::left << std::setw(32) << entry.first << std::right
+        << std::setw(10) << h.count() << std::setw(12) << h.totalNanoseconds() / 1e6
+        << std::setw(12) << h.meanNanoseconds() / 1e3 << std::setw(12) << h.minNanoseconds() / 1e3
+        << std::setw(12) << h.percentileNanoseconds(0.5) / 1e3 << std::setw(12) << h.percentileNanoseconds(0.99) / 1e3
+        << std::setw(12) << h.maxNanoseconds() / 1e3 << "\n";
+    }
+    os.flags(oldFlags);
+    os.precision(oldPrecision);
+  }
+
+private:
+  mutable std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<TimingSite>> sites_;
+  std::atomic<bool> reportAtExit_;
+
+  bool hasRecordings() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : sites_) {
+      if (entry.second->snapshot().count()) return true;
+    }
+    return false;
+  }
+};
+
+// -------------------------------------------------------------------
+// ScopedTimer class
+// -------------------------------------------------------------------
+// Measures the time from its creation until it goes out of scope, and
+// records it in a timing site. For example:
+//
+//   {
+//     ScopedTimer timer("sortWordCounts");
+//     ... the code to measure ...
+//   } // recorded here
+//
+// Giving a label looks up its site in the registry, which takes a lock.
+// Code that runs often should look the site up once and pass that instead,
+// which is what INSTRUMENT_SCOPE does.
+class ScopedTimer {
+public:
+  explicit ScopedTimer(TimingSite& site) : site_(site), startTime_(getTimeNow()) {}
+
+  explicit ScopedTimer(const char* label, TimingRegistry& registry=TimingRegistry::global())
+    : site_(registry.site(label)), startTime_(getTimeNow()) {}
+
+  ~ScopedTimer() {
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(getTimeNow() - startTime_);
+    site_.record(static_cast<std::uint64_t>(std::max<long long>(0, elapsed.count())));
+  }
+
+  ScopedTimer(const ScopedTimer& other) = delete;
+  ScopedTimer& operator=(const ScopedTimer& other) = delete;
+
+private:
+  TimingSite& site_;
+  timeUnit startTime_;
+};
+
+// INSTRUMENT_SCOPE(label) times the rest of the enclosing block with the
+// global registry. The label is looked up only the first time the block
+// runs, and kept in a function-local static, so each later run just reads
+// the clock twice and updates a few atomic counters. It does nothing at
+// all unless ENABLE_INSTRUMENTATION is defined, so it can be left in the
+// code at no cost.
+#ifdef ENABLE_INSTRUMENTATION
+#define INSTRUMENT_CONCAT_INNER(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_INNER(a, b)
+#define INSTRUMENT_SCOPE(label) \
+  static TimingSite& INSTRUMENT_CONCAT(instrumentScopeSite_, __LINE__) = TimingRegistry::global().site(label); \
+  ScopedTimer INSTRUMENT_CONCAT(instrumentScopeTimer_, __LINE__)(INSTRUMENT_CONCAT(instrumentScopeSite_, __LINE__))
+#else
+#define INSTRUMENT_SCOPE(label) do {} while (false)
+#endif
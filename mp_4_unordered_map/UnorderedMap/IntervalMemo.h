@@ -0,0 +1,171 @@
+/**
+ * @file IntervalMemo.h
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * A dense memoization table for problems on intervals of a sequence.
+ *
+**/
+
+#pragma once
+
+#include <cstddef> // for std::size_t
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::out_of_range
+#include <utility> // for std::make_pair
+#include <vector> // for std::vector
+
+#include "IntPair.h"
+
+// -------------------------------------------------------------------
+// IntervalMemo<Cell> class
+// -------------------------------------------------------------------
+// LengthMemo is a std::unordered_map from (left, right) index pairs to
+// results. That works for any pairs at all, but every lookup has to hash
+// the pair (our hasher in IntPair.h even builds a temporary string to do
+// it) and then follow pointers to a separately allocated node.
+//
+// In interval problems like the palindrome exercise, though, the keys are
+// always intervals of one sequence: 0 <= left <= right+1, where left ==
+// right+1 means an empty interval. So a plain array can hold one cell for
+// every possible interval, and a key can be turned into an array position
+// with a little arithmetic instead of hashing.
+//
+// The cells are stored column by column: all intervals ending at right
+// come after all the intervals ending before it. Column right holds the
+// right+2 intervals from (0, right) to (right+1, right), and column -1
+// holds only the empty interval (0, -1). So (left, right) is at position
+//
+//   c*(c+1)/2 + left,  where c = right+1.
+//
+// Only the n*n/2 or so valid intervals take space (the "upper triangle" of
+// an n-by-n table), and because a longer sequence only adds columns at the
+// end, the table can grow as larger right limits are used, without moving
+// any existing cells. That means it can be created empty, just like a
+// LengthMemo.
+//
+// The Cell type sets the size of each result: int by default, or a smaller
+// type like std::int16_t to halve the memory, if the results are known to
+// fit. One value of Cell (the smallest) is reserved to mark cells that
+// haven't been filled in yet.
+//
+// The interface matches the parts of std::unordered_map that the palindrome
+// code uses (count, at, and operator[] with IntPair keys), so LengthMemo
+// can be switched to this type (see UnorderedMapCommon.h).
+
+template <typename Cell = int>
+class IntervalMemo {
+public:
+  using key_type = IntPair;
+  using mapped_type = Cell;
+  using size_type = std::size_t;
+
+  // The value marking a cell that hasn't been set.
+  static constexpr Cell UNSET = std::numeric_limits<Cell>::min();
+
+  // Create an empty table. It grows automatically as needed.
+  IntervalMemo() : setCount_(0) {}
+
+  // Create a table with room for all intervals of a sequence of the
+  // given length, so it never needs to grow.
+  explicit IntervalMemo(int sequenceLength) : IntervalMemo() {
+    reserveColumns(sequenceLength);
+  }
+
+  // Returns 1 if the interval's result has been set, and 0 otherwise.
+  // (Keys that aren't valid intervals are never set.)
+  size_type count(const IntPair& key) const {
+    if (!isValidKey(key)) return 0;
+    std::size_t position = positionOf(key);
+    return (position < cells_.size() && UNSET != cells_[position]) ? 1 : 0;
+  }
+
+  // The result for an interval that must have been set. Throws
+  // std::out_of_range otherwise, like std::unordered_map::at.
+  const Cell& at(const IntPair& key) const {
+    if (!count(key)) {
+      throw std::out_of_range("IntervalMemo::at: interval not set");
+    }
+    return cells_[positionOf(key)];
+  }
+
+  Cell& at(const IntPair& key) {
+    if (!count(key)) {
+      throw std::out_of_range("IntervalMemo::at: interval not set");
+    }
+    return cells_[positionOf(key)];
+  }
+
+  // Access the result for an interval. Like std::unordered_map, if it
+  // hasn't been set yet, it's set to 0 first. Throws std::out_of_range if
+  // the key isn't a valid interval.
+  Cell& operator[](const IntPair& key) {
+    if (!isValidKey(key)) {
+      throw std::out_of_range("IntervalMemo: key is not an interval (need 0 <= left <= right+1)");
+    }
+    reserveColumns(key.second + 1);
+    Cell& cell = cells_[positionOf(key)];
+    if (UNSET == cell) {
+      cell = 0;
+      setCount_++;
+    }
+    return cell;
+  }
+
+  // Number of intervals that have been set.
+  size_type size() const { return setCount_; }
+  bool empty() const { return 0 == setCount_; }
+
+  // Mark every interval as unset, keeping the memory.
+  void clear() {
+    cells_.assign(cells_.size(), UNSET);
+    setCount_ = 0;
+  }
+
+  // Make room for all intervals of a sequence of the given length.
+  void reserveColumns(int sequenceLength) {
+    // Columns -1 through sequenceLength-1, so c goes up to sequenceLength.
+    std::size_t c = static_cast<std::size_t>(sequenceLength);
+    std::size_t needed = (c + 1) * (c + 2) / 2;
+    if (needed > cells_.size()) {
+      cells_.resize(needed, UNSET);
+    }
+  }
+
+  // Direct access to the cells of column right (the intervals (0, right)
+  // through (right+1, right), in order of left), for code that fills in a
+  // whole table quickly. There are no checks, the table doesn't grow, and
+  // cells written this way aren't counted by size() until recount() is
+  // called. Different threads may write different cells at the same time,
+  // as long as reserveColumns was called first.
+  Cell* column(int right) { return cells_.data() + positionOf(std::make_pair(0, right)); }
+  const Cell* column(int right) const { return cells_.data() + positionOf(std::make_pair(0, right)); }
+
+  // Update size() after cells were written through column().
+  void recount() {
+    setCount_ = 0;
+    for (const Cell& cell : cells_) {
+      if (UNSET != cell) setCount_++;
+    }
+  }
+
+  // Bytes used by the cells.
+  std::size_t memoryBytes() const { return cells_.capacity() * sizeof(Cell); }
+
+private:
+  std::vector<Cell> cells_;
+  size_type setCount_;
+
+  static bool isValidKey(const IntPair& key) {
+    return key.first >= 0 && key.second >= -1 && key.first <= key.second + 1;
+  }
+
+  static std::size_t positionOf(const IntPair& key) {
+    std::size_t c = static_cast<std::size_t>(key.second + 1);
+    return c * (c + 1) / 2 + static_cast<std::size_t>(key.first);
+  }
+};
+
+// In some versions of C++ we have to redeclare a constant static member
+// at global scope like this to ensure that the linker doesn't give an error.
+template <typename Cell>
+constexpr Cell IntervalMemo<Cell>::UNSET;
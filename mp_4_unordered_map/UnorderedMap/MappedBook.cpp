@@ -0,0 +1,165 @@
+/**
+ * @file MappedBook.cpp
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * A fast, zero-copy alternative to loadBookStrings.
+ *
+**/
+
+#include <algorithm> // for std::search, std::find, std::equal
+#include <cctype> // for std::isalpha, std::tolower
+#include <cstring> // for std::strlen
+#include <stdexcept> // for std::runtime_error
+
+// POSIX headers for memory-mapping files
+#include <fcntl.h> // for open
+#include <sys/mman.h> // for mmap, munmap
+#include <sys/stat.h> // for fstat
+#include <unistd.h> // for close
+
+#include "MappedBook.h"
+#include "Instrumentation.h"
+
+// Returns a pointer to the first occurrence of text in [begin, end),
+// or end if it isn't found.
+static char* findText(char* begin, char* end, const char* text) {
+  return std::search(begin, end, text, text + std::strlen(text));
+}
+
+// Store a character, but only if it's different from what is already
+// there. Writing to a page of a private mapping makes the OS copy that
+// page, so we avoid writes that wouldn't change anything.
+static inline void putChar(char*& dest, char c) {
+  if (*dest != c) *dest = c;
+  dest++;
+}
+
+void MappedBook::tokenizeInPlace(char* begin, char* end, unsigned int min_word_length, std::vector<WordView>& words) {
+
+  // The UTF-8 bytes for a right single quotation mark, which loadBookStrings
+  // treats as a plain ASCII apostrophe.
+  static const char RIGHT_QUOTE[] = "\xE2\x80\x99";
+
+  // This follows the same rules as loadBookStrings, character by character.
+  // The one difference is that loadBookStrings first rewrites the line to
+  // change curly apostrophes to plain ones and "--" to a space; here we
+  // recognize those sequences as we come to them instead.
+  char* p = begin;
+  while (p < end) {
+    // Start a new word. As we parse it, the lowercased word is written back
+    // starting at the same position. The output never gets ahead of the
+    // input, because every character written stands for at least one
+    // character that has already been read.
+    char* wordStart = p;
+    char* dest = p;
+    char prevChar = ' ';
+
+    while (p < end) {
+      const unsigned char c = static_cast<unsigned char>(*p);
+      if (std::isalpha(c)) {
+        if (prevChar == '\'') {
+          // [letter][apostrophe][letter]: keep the apostrophe.
+          putChar(dest, '\'');
+        }
+        else if (prevChar == '-') {
+          // [letter][dash][letter]: keep the dash.
+          putChar(dest, '-');
+        }
+        const char thisChar = static_cast<char>(std::tolower(c));
+        putChar(dest, thisChar);
+        prevChar = thisChar;
+        p++;
+      }
+      else if ('\'' == c || (end - p >= 3 && std::equal(RIGHT_QUOTE, RIGHT_QUOTE + 3, p))) {
+        // Only note an apostrophe if it follows a letter.
+        prevChar = std::isalpha(static_cast<unsigned char>(prevChar)) ? '\'' : ' ';
+        p += ('\'' == c) ? 1 : 3;
+      }
+      else if ('-' == c && !(end - p >= 2 && '-' == p[1])) {
+        // Only note a single dash if it follows a letter.
+        prevChar = std::isalpha(static_cast<unsigned char>(prevChar)) ? '-' : ' ';
+        p++;
+      }
+      else {
+        // Any other character ends the word. A double dash counts as a
+        // single separator, like the space that loadBookStrings puts there.
+        p += ('-' == c) ? 2 : 1;
+        break;
+      }
+    }
+
+    const std::size_t wordLength = dest - wordStart;
+    if (wordLength >= min_word_length && wordLength > 0) {
+      words.push_back(WordView(wordStart, wordLength));
+    }
+  }
+}
+
+MappedBook::MappedBook(unsigned int min_word_length, const std::string& filename)
+  : mapping_(nullptr), mappingBytes_(0) {
+  INSTRUMENT_SCOPE("MappedBook");
+
+  static const char start_text[] = "CHAPTER I";
+  static const char end_text[] = "End of the Project Gutenberg EBook";
+
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Could not load book file: " + filename);
+  }
+  struct stat fileInfo;
+  if (fstat(fd, &fileInfo) != 0) {
+    close(fd);
+    throw std::runtime_error("Could not load book file: " + filename);
+  }
+  std::size_t fileBytes = static_cast<std::size_t>(fileInfo.st_size);
+  if (0 == fileBytes) {
+    // Nothing to map, and no words to find.
+    close(fd);
+    return;
+  }
+
+  // A private mapping can be written to without changing the file. The OS
+  // gives us our own copy of each page the first time we write to it.
+  void* mapping = mmap(nullptr, fileBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (MAP_FAILED == mapping) {
+    throw std::runtime_error("Could not map book file: " + filename);
+  }
+  mapping_ = static_cast<char*>(mapping);
+  mappingBytes_ = fileBytes;
+
+  char* fileEnd = mapping_ + mappingBytes_;
+
+  // Skip the introduction: The text begins on the line after the first
+  // line containing start_text. (If there is no such line, there are no words.)
+  char* textBegin = findText(mapping_, fileEnd, start_text);
+  if (fileEnd == textBegin) return;
+  textBegin = std::find(textBegin, fileEnd, '\n');
+  if (fileEnd != textBegin) textBegin++;
+
+  // The text ends at the beginning of the first line after that which
+  // contains end_text, so that the legal disclaimers aren't included.
+  char* textEnd = findText(textBegin, fileEnd, end_text);
+  if (fileEnd != textEnd) {
+    while (textEnd != textBegin && '\n' != textEnd[-1]) {
+      textEnd--;
+    }
+  }
+
+  tokenizeInPlace(textBegin, textEnd, min_word_length, words_);
+}
+
+MappedBook::~MappedBook() {
+  if (mapping_) {
+    munmap(mapping_, mappingBytes_);
+  }
+}
+
+StringVec MappedBook::toStringVec() const {
+  StringVec bookstrings;
+  bookstrings.reserve(words_.size());
+  for (const WordView& word : words_) {
+    bookstrings.push_back(word.str());
+  }
+  return bookstrings;
+}
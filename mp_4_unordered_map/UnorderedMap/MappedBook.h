@@ -0,0 +1,61 @@
+/**
+ * @file MappedBook.h
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * A fast, zero-copy alternative to loadBookStrings.
+ *
+**/
+
+#pragma once
+
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+#include "UnorderedMapCommon.h"
+#include "WordView.h"
+
+// MappedBook loads the same words as loadBookStrings, with the same start
+// and end markers, the same min_word_length filtering, and the same rules
+// for lowercase letters, apostrophes, and hyphens. But instead of reading
+// the file line by line and building a separate std::string for each word,
+// it memory-maps the whole file and tokenizes it in place:
+//
+// - Each word is lowercased right where it is in the mapped file, and the
+//   result is a WordView that points at those characters. No string is
+//   allocated per word.
+// - The mapping is private, so the file on disk is never changed. Only the
+//   pages that actually need edits (for capital letters, or curly
+//   apostrophes that are shortened to plain ones) get copied by the OS.
+//
+// The WordView results are only valid while the MappedBook exists.
+// (Unlike loadBookStrings, empty words are never included, even if
+// min_word_length is 0.)
+class MappedBook {
+public:
+  explicit MappedBook(unsigned int min_word_length=5,
+    const std::string& filename="through_the_looking_glass.txt");
+
+  // Disable copying, since this object owns the mapping.
+  MappedBook(const MappedBook& other) = delete;
+  MappedBook& operator=(const MappedBook& other) = delete;
+
+  ~MappedBook();
+
+  // The words of the book, in order.
+  const std::vector<WordView>& words() const { return words_; }
+
+  // Copy the words into ordinary strings, giving the same result as
+  // loadBookStrings.
+  StringVec toStringVec() const;
+
+  // Tokenize a character buffer in place, appending the words found to
+  // the output vector. (This is the same parsing used for the mapped file,
+  // but it skips the search for the start and end markers.) The buffer is
+  // modified: words are lowercased and shifted to remove extra bytes.
+  static void tokenizeInPlace(char* begin, char* end, unsigned int min_word_length, std::vector<WordView>& words);
+
+private:
+  char* mapping_;
+  std::size_t mappingBytes_;
+  std::vector<WordView> words_;
+};
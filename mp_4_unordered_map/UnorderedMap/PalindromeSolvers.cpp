@@ -0,0 +1,90 @@
+/**
+ * @file PalindromeSolvers.cpp
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * Faster ways to find the longest palindrome substring.
+ *
+**/
+
+#include <algorithm> // for std::min
+#include <stdexcept> // for std::runtime_error, std::out_of_range
+#include <vector> // for std::vector
+
+#include "PalindromeSolvers.h"
+#include "Instrumentation.h"
+
+PalindromeSpan manacherLongestPalindromeSpan(const std::string& str, int leftLimit, int rightLimit) {
+  INSTRUMENT_SCOPE("manacherLongestPalindromeSpan");
+  if (leftLimit > rightLimit) {
+    return PalindromeSpan{leftLimit, 0};
+  }
+  if (leftLimit < 0) {
+    throw std::runtime_error("leftLimit negative");
+  }
+  if (static_cast<std::size_t>(rightLimit) >= str.length()) {
+    throw std::out_of_range("rightLimit past the end of the string");
+  }
+
+  const char* s = str.data() + leftLimit;
+  const int n = rightLimit - leftLimit + 1;
+
+  PalindromeSpan best{leftLimit, 0};
+  // Record a palindrome if it's longer than the best so far, or equally
+  // long but further left.
+  auto consider = [&](int start, int length) {
+    if (length > best.length || (length == best.length && leftLimit + start < best.left)) {
+      best = PalindromeSpan{leftLimit + start, length};
+    }
+  };
+
+  // Odd-length palindromes: oddRadius[i] = k means that the palindrome
+  // centered on character i extends k-1 characters to each side.
+  // We track [l, r], the rightmost-ending palindrome found so far. For a
+  // center i inside it, the mirror image center l+r-i already tells us a
+  // lower bound for the radius at i, so we don't compare those characters
+  // again. Each comparison that succeeds moves r to the right, so the total
+  // work is O(n).
+  std::vector<int> oddRadius(n);
+  for (int i = 0, l = 0, r = -1; i < n; i++) {
+    int k = (i > r) ? 1 : std::min(oddRadius[l + r - i], r - i + 1);
+    while (i - k >= 0 && i + k < n && s[i - k] == s[i + k]) {
+      k++;
+    }
+    oddRadius[i] = k;
+    consider(i - k + 1, 2 * k - 1);
+    if (i + k - 1 > r) {
+      l = i - k + 1;
+      r = i + k - 1;
+    }
+  }
+
+  // Even-length palindromes: evenRadius[i] = k means that the palindrome
+  // centered between characters i-1 and i extends k characters to each side.
+  std::vector<int> evenRadius(n);
+  for (int i = 0, l = 0, r = -1; i < n; i++) {
+    int k = (i > r) ? 0 : std::min(evenRadius[l + r - i + 1], r - i + 1);
+    while (i - k - 1 >= 0 && i + k < n && s[i - k - 1] == s[i + k]) {
+      k++;
+    }
+    evenRadius[i] = k;
+    if (k > 0) {
+      consider(i - k, 2 * k);
+    }
+    if (i + k - 1 > r) {
+      l = i - k;
+      r = i + k - 1;
+    }
+  }
+
+  return best;
+}
+
+int manacherLongestPalindromeLength(const std::string& str, int leftLimit, int rightLimit) {
+  return manacherLongestPalindromeSpan(str, leftLimit, rightLimit).length;
+}
+
+std::string findLongestPalindrome(const std::string& str) {
+  if (str.empty()) return "";
+  PalindromeSpan span = manacherLongestPalindromeSpan(str, 0, static_cast<int>(str.length()) - 1);
+  return str.substr(span.left, span.length);
+}
@@ -0,0 +1,132 @@
+/**
+ * @file PalindromeSolvers.h
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * Faster ways to find the longest palindrome substring.
+ *
+**/
+
+#pragma once
+
+#include <algorithm> // for std::max
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::length_error
+#include <string> // for std::string
+#include <utility> // for std::make_pair
+
+#include "UnorderedMapCommon.h"
+#include "IntervalMemo.h"
+
+// The position of a palindrome substring: it begins at index left of the
+// original string and has the given length.
+struct PalindromeSpan {
+  int left;
+  int length;
+};
+
+// manacherLongestPalindromeSpan finds the longest palindrome substring
+// between the given index limits (inclusive), with the same meaning as
+// longestPalindromeLength. Instead of recursing over every pair of limits,
+// it uses Manacher's algorithm, which looks at each possible center of a
+// palindrome once and reuses what it learned from earlier centers, so it
+// takes O(n) time and two arrays of n ints, with no hash table at all.
+//
+// The span found also tells us where the palindrome is, which is what
+// reconstructPalindrome works out from the memoization table. If several
+// palindromes have the longest length, the leftmost one is returned.
+// If leftLimit > rightLimit, the result has length 0.
+PalindromeSpan manacherLongestPalindromeSpan(const std::string& str, int leftLimit, int rightLimit);
+
+// Just the length, for comparison with longestPalindromeLength.
+int manacherLongestPalindromeLength(const std::string& str, int leftLimit, int rightLimit);
+
+// The longest palindrome substring of the whole string (the leftmost one,
+// if there is a tie).
+std::string findLongestPalindrome(const std::string& str);
+
+// -------------------------------------------------------------------
+// Filling in a whole memoization table
+// -------------------------------------------------------------------
+// memoizedLongestPalindromeLength fills in the memo from the top down, by
+// recursion. tabulateLongestPalindromeLengths fills it in from the bottom
+// up instead: it records the answer for every interval of str, shortest
+// intervals first within each column, so each answer only needs the
+// answers already recorded for (left+1, right-1), (left, right-1) and
+// (left+1, right). It returns the length for the whole string.
+//
+// This works with any memo type that has operator[] for IntPair keys,
+// including LengthMemo and IntervalMemo. Visiting the intervals column by
+// column is also the order that IntervalMemo stores them in.
+template <typename Memo>
+int tabulateLongestPalindromeLengths(Memo& memo, const std::string& str);
+
+// reconstructPalindromeFromMemo finds the same palindrome as
+// reconstructPalindrome, for any memo type with count and at for IntPair
+// keys. It only reads the memo, so it doesn't make a copy first. (Intervals
+// that aren't in the memo count as length 0, as in reconstructPalindrome.)
+template <typename Memo>
+std::string reconstructPalindromeFromMemo(const Memo& memo, const std::string& str);
+
+// ===================================================================
+// Template implementations
+// ===================================================================
+
+template <typename Memo>
+int tabulateLongestPalindromeLengths(Memo& memo, const std::string& str) {
+  using Length = typename Memo::mapped_type;
+  const int n = str.length();
+  if (static_cast<long long>(n) > static_cast<long long>(std::numeric_limits<Length>::max())) {
+    throw std::length_error("tabulateLongestPalindromeLengths: string too long for the memo's cell type");
+  }
+
+  memo[std::make_pair(0, -1)] = 0;
+  for (int right = 0; right < n; right++) {
+    memo[std::make_pair(right+1, right)] = 0;
+    memo[std::make_pair(right, right)] = 1;
+    for (int left = right-1; left >= 0; left--) {
+      // Same cases as memoizedLongestPalindromeLength: if the ends match
+      // and everything between them is a palindrome, so is the interval.
+      const int middleMaxLength = right-left-1;
+      if (str[left] == str[right] && memo[std::make_pair(left+1, right-1)] == middleMaxLength) {
+        memo[std::make_pair(left, right)] = static_cast<Length>(middleMaxLength + 2);
+      }
+      else {
+        const Length leftSubproblemResult = memo[std::make_pair(left, right-1)];
+        const Length rightSubproblemResult = memo[std::make_pair(left+1, right)];
+        memo[std::make_pair(left, right)] = std::max(leftSubproblemResult, rightSubproblemResult);
+      }
+    }
+  }
+  return memo[std::make_pair(0, n-1)];
+}
+
+template <typename Memo>
+std::string reconstructPalindromeFromMemo(const Memo& memo, const std::string& str) {
+  if (!str.length()) return "";
+
+  auto lengthOf = [&memo](int left, int right) -> int {
+    const IntPair key = std::make_pair(left, right);
+    return memo.count(key) ? static_cast<int>(memo.at(key)) : 0;
+  };
+
+  int left = 0;
+  int right = str.length()-1;
+  const int BEST_LEN = lengthOf(left, right);
+
+  // Narrow the limits while the interval still contains a palindrome of
+  // the best length.
+  bool loop_again = true;
+  while (loop_again) {
+    loop_again = false;
+    if (left+1 <= right && lengthOf(left+1, right) == BEST_LEN) {
+      left++;
+      loop_again = true;
+    }
+    if (left <= right-1 && lengthOf(left, right-1) == BEST_LEN) {
+      right--;
+      loop_again = true;
+    }
+  }
+
+  return (left <= right) ? str.substr(left, right-left+1) : "";
+}
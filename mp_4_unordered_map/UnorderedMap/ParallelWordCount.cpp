@@ -0,0 +1,75 @@
+/**
+ * @file ParallelWordCount.cpp
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * Multi-threaded word counting for large inputs.
+ *
+**/
+
+#include <algorithm> // for std::min, std::max, std::max_element
+#include <functional> // for std::cref, std::ref
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+#include <utility> // for std::move
+
+#include "ParallelWordCount.h"
+#include "Instrumentation.h"
+
+// Count one range of the input into a map. Using the [] operator, each word
+// is hashed only once: a missing key is inserted with the value 0 and then
+// incremented.
+static void countRange(const StringVec& words, std::size_t begin, std::size_t end, StringIntMap& counts) {
+  for (std::size_t i = begin; i < end; i++) {
+    counts[words[i]]++;
+  }
+}
+
+StringIntMap makeWordCountsParallel(const StringVec& words, unsigned int threadCount) {
+  INSTRUMENT_SCOPE("makeWordCountsParallel");
+
+  // Each thread should have at least this many words to count. Below that,
+  // the cost of starting a thread and merging its map isn't worth it.
+  constexpr std::size_t MIN_WORDS_PER_THREAD = 16 * 1024;
+
+  if (0 == threadCount) {
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+  }
+  std::size_t maxUsefulThreads = std::max<std::size_t>(1, words.size() / MIN_WORDS_PER_THREAD);
+  std::size_t shardCount = std::min<std::size_t>(threadCount, maxUsefulThreads);
+
+  if (1 == shardCount) {
+    StringIntMap wordcount_map;
+    countRange(words, 0, words.size(), wordcount_map);
+    return wordcount_map;
+  }
+
+  // Shard i covers words [i*n/shardCount, (i+1)*n/shardCount). The calling
+  // thread counts shard 0 itself while the other threads run.
+  std::vector<StringIntMap> partialCounts(shardCount);
+  std::vector<std::thread> threads;
+  threads.reserve(shardCount - 1);
+  auto shardBegin = [&](std::size_t shard) {
+    return words.size() * shard / shardCount;
+  };
+  for (std::size_t shard = 1; shard < shardCount; shard++) {
+    threads.emplace_back(countRange, std::cref(words), shardBegin(shard), shardBegin(shard + 1),
+      std::ref(partialCounts[shard]));
+  }
+  countRange(words, shardBegin(0), shardBegin(1), partialCounts[0]);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Merge everything into the largest partial map, so that the fewest
+  // entries have to be re-inserted.
+  auto largest = std::max_element(partialCounts.begin(), partialCounts.end(),
+    [](const StringIntMap& a, const StringIntMap& b) { return a.size() < b.size(); });
+  StringIntMap wordcount_map = std::move(*largest);
+  for (auto& partial : partialCounts) {
+    if (&partial == &*largest) continue;
+    for (const auto& wordcount : partial) {
+      wordcount_map[wordcount.first] += wordcount.second;
+    }
+  }
+  return wordcount_map;
+}
@@ -0,0 +1,26 @@
+/**
+ * @file ParallelWordCount.h
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * Multi-threaded word counting for large inputs.
+ *
+**/
+
+#pragma once
+
+#include "UnorderedMapCommon.h"
+
+// makeWordCountsParallel gives the same result as makeWordCounts, but it
+// splits the input into contiguous shards and counts each shard on its own
+// thread. Every thread counts into its own private StringIntMap, so the
+// threads never have to wait for each other while counting. At the end,
+// the partial maps are merged together into one result.
+//
+// The merge only visits each thread's unique words, not every occurrence,
+// so it stays cheap as long as the input has many repeated words (which is
+// the usual case for text and logs).
+//
+// If threadCount is 0, one thread is used per hardware core. Small inputs
+// are counted on the calling thread, since starting threads would cost more
+// than it saves.
+StringIntMap makeWordCountsParallel(const StringVec& words, unsigned int threadCount=0);
@@ -0,0 +1,250 @@
+/**
+ * @file StreamingWordCounter.cpp
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * Approximate word counting in a fixed amount of memory.
+ *
+**/
+
+#include <algorithm> // for std::min, std::max, std::sort
+#include <cmath> // for std::ceil, std::log, std::exp
+#include <functional> // for std::hash
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::runtime_error
+#include <utility> // for std::swap
+
+#include "StreamingWordCounter.h"
+
+// Scramble the bits of a 64-bit value (the "splitmix64" finalizer). We use
+// this to make a second, independent-looking hash from std::hash's result.
+static inline std::uint64_t mixBits(std::uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xBF58476D1CE4E5B9ULL;
+  x ^= x >> 27;
+  x *= 0x94D049BB133111EBULL;
+  x ^= x >> 31;
+  return x;
+}
+
+// ========================================================================
+//   CountMinSketch
+// ========================================================================
+
+CountMinSketch::CountMinSketch(double epsilon, double delta) : total_(0) {
+  if (!(epsilon > 0.0 && epsilon < 1.0) || !(delta > 0.0 && delta < 1.0)) {
+    throw std::runtime_error("CountMinSketch: epsilon and delta must be between 0 and 1");
+  }
+  width_ = static_cast<std::size_t>(std::ceil(std::exp(1.0) / epsilon));
+  depth_ = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(std::log(1.0 / delta))));
+  counters_.assign(width_ * depth_, 0);
+}
+
+CountMinSketch::WordHashes CountMinSketch::hashWord(const std::string& word) {
+  // Rather than computing depth_ separate hash functions, we combine two
+  // hashes as h1 + i*h2 for row i, which is known to work just as well
+  // for this purpose (Kirsch and Mitzenmacher, 2006).
+  WordHashes hashes;
+  hashes.h1 = std::hash<std::string>()(word);
+  hashes.h2 = mixBits(hashes.h1) | 1;
+  return hashes;
+}
+
+void CountMinSketch::add(const std::string& word, int count) {
+  if (count <= 0) return;
+  const WordHashes hashes = hashWord(word);
+
+  int current = std::numeric_limits<int>::max();
+  for (std::size_t row = 0; row < depth_; row++) {
+    current = std::min(current, counters_[counterIndex(hashes, row)]);
+  }
+  // Conservative update: raise each counter to at least the new estimate,
+  // but leave counters that are already higher alone. (Counts saturate
+  // rather than overflow.)
+  const int updated = (current > std::numeric_limits<int>::max() - count)
+    ? std::numeric_limits<int>::max() : current + count;
+  for (std::size_t row = 0; row < depth_; row++) {
+    int& counter = counters_[counterIndex(hashes, row)];
+    counter = std::max(counter, updated);
+  }
+  total_ += count;
+}
+
+int CountMinSketch::estimate(const std::string& word) const {
+  const WordHashes hashes = hashWord(word);
+  int result = std::numeric_limits<int>::max();
+  for (std::size_t row = 0; row < depth_; row++) {
+    result = std::min(result, counters_[counterIndex(hashes, row)]);
+  }
+  return result;
+}
+
+// ========================================================================
+//   SpaceSavingCounter
+// ========================================================================
+
+// In some versions of C++ we have to redeclare constant static members
+// at global scope like this to ensure that the linker doesn't give an error.
+constexpr std::uint32_t SpaceSavingCounter::EMPTY_SLOT;
+
+// Add one to a count, stopping at the largest int.
+static inline int saturatingIncrement(int count) {
+  return (count < std::numeric_limits<int>::max()) ? count + 1 : count;
+}
+
+SpaceSavingCounter::SpaceSavingCounter(std::size_t capacity) : capacity_(capacity), total_(0) {
+  if (0 == capacity_) {
+    throw std::runtime_error("SpaceSavingCounter: capacity must be at least 1");
+  }
+  if (capacity_ >= EMPTY_SLOT / 2) {
+    throw std::runtime_error("SpaceSavingCounter: capacity is too large");
+  }
+  entries_.reserve(capacity_);
+  heap_.reserve(capacity_);
+  std::size_t slotCount = 2;
+  while (slotCount < 2 * capacity_) {
+    slotCount *= 2;
+  }
+  slots_.assign(slotCount, EMPTY_SLOT);
+}
+
+std::size_t SpaceSavingCounter::findSlot(const std::string& word, std::size_t hash) const {
+  const std::size_t mask = slots_.size() - 1;
+  std::size_t slot = hash & mask;
+  while (EMPTY_SLOT != slots_[slot]) {
+    const Entry& entry = entries_[slots_[slot]];
+    if (entry.hash == hash && entry.word == word) break;
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+void SpaceSavingCounter::eraseSlot(std::size_t slot) {
+  // Look at the entries after the gap, up to the next empty slot. An entry
+  // whose home slot (where its hash points) isn't between the gap and where
+  // it is now would no longer be found past the gap, so it moves into the
+  // gap, which leaves a new gap where it was.
+  const std::size_t mask = slots_.size() - 1;
+  std::size_t gap = slot;
+  for (std::size_t next = (gap + 1) & mask; EMPTY_SLOT != slots_[next]; next = (next + 1) & mask) {
+    const std::size_t home = entries_[slots_[next]].hash & mask;
+    if (((next - home) & mask) >= ((next - gap) & mask)) {
+      slots_[gap] = slots_[next];
+      gap = next;
+    }
+  }
+  slots_[gap] = EMPTY_SLOT;
+}
+
+void SpaceSavingCounter::swapHeapPositions(std::size_t a, std::size_t b) {
+  std::swap(heap_[a], heap_[b]);
+  entries_[heap_[a]].heapPosition = a;
+  entries_[heap_[b]].heapPosition = b;
+}
+
+void SpaceSavingCounter::siftDown(std::size_t position) {
+  while (true) {
+    std::size_t smallest = position;
+    std::size_t left = 2 * position + 1;
+    std::size_t right = left + 1;
+    if (left < heap_.size() && entries_[heap_[left]].count < entries_[heap_[smallest]].count) smallest = left;
+    if (right < heap_.size() && entries_[heap_[right]].count < entries_[heap_[smallest]].count) smallest = right;
+    if (smallest == position) return;
+    swapHeapPositions(position, smallest);
+    position = smallest;
+  }
+}
+
+void SpaceSavingCounter::siftUp(std::size_t position) {
+  while (position > 0 && entries_[heap_[(position - 1) / 2]].count > entries_[heap_[position]].count) {
+    swapHeapPositions(position, (position - 1) / 2);
+    position = (position - 1) / 2;
+  }
+}
+
+void SpaceSavingCounter::add(const std::string& word) {
+  total_++;
+
+  const std::size_t hash = std::hash<std::string>()(word);
+  const std::size_t slot = findSlot(word, hash);
+  if (EMPTY_SLOT != slots_[slot]) {
+    // Already tracked: count it, and move it down the heap if needed.
+    Entry& entry = entries_[slots_[slot]];
+    entry.count = saturatingIncrement(entry.count);
+    siftDown(entry.heapPosition);
+    return;
+  }
+
+  if (entries_.size() < capacity_) {
+    // There's still room. Add the word at the end of the heap and move it
+    // up past any entries with larger counts.
+    const std::uint32_t index = static_cast<std::uint32_t>(entries_.size());
+    entries_.push_back(Entry{word, 1, 0, hash, heap_.size()});
+    heap_.push_back(index);
+    slots_[slot] = index;
+    siftUp(heap_.size() - 1);
+    return;
+  }
+
+  // Replace the word with the smallest count. The new word might have
+  // occurred up to that many times before without being tracked. Its
+  // entry is reused as it is, so nothing is allocated unless the new word
+  // is longer than any word the entry has held before.
+  const std::uint32_t index = heap_.front();
+  Entry& smallest = entries_[index];
+  eraseSlot(findSlot(smallest.word, smallest.hash));
+  smallest.word.assign(word);
+  smallest.hash = hash;
+  smallest.error = smallest.count;
+  smallest.count = saturatingIncrement(smallest.count);
+  // Removing the old word may have moved the empty slot we found earlier.
+  slots_[findSlot(word, hash)] = index;
+  siftDown(0);
+}
+
+int SpaceSavingCounter::estimate(const std::string& word) const {
+  const std::size_t slot = findSlot(word, std::hash<std::string>()(word));
+  return (EMPTY_SLOT == slots_[slot]) ? 0 : entries_[slots_[slot]].count;
+}
+
+int SpaceSavingCounter::maxError(const std::string& word) const {
+  const std::size_t slot = findSlot(word, std::hash<std::string>()(word));
+  return (EMPTY_SLOT == slots_[slot]) ? 0 : entries_[slots_[slot]].error;
+}
+
+StringIntPairVec SpaceSavingCounter::top(unsigned int max_words) const {
+  StringIntPairVec results;
+  results.reserve(entries_.size());
+  for (const Entry& entry : entries_) {
+    results.push_back(StringIntPair(entry.word, entry.count));
+  }
+  std::sort(results.begin(), results.end(), [](const StringIntPair& x, const StringIntPair& y) {
+    return x.second > y.second || (x.second == y.second && x.first < y.first);
+  });
+  if (results.size() > max_words) {
+    results.resize(max_words);
+  }
+  return results;
+}
+
+// ========================================================================
+//   StreamingWordCounter
+// ========================================================================
+
+StreamingWordCounter::StreamingWordCounter(double epsilon, double delta, std::size_t heavyHitterCapacity)
+  : sketch_(epsilon, delta), heavyHitters_(heavyHitterCapacity) {}
+
+void StreamingWordCounter::add(const std::string& word) {
+  sketch_.add(word);
+  heavyHitters_.add(word);
+}
+
+void StreamingWordCounter::addAll(const StringVec& words) {
+  for (const std::string& word : words) {
+    add(word);
+  }
+}
+
+int lookupWithFallback(const StreamingWordCounter& counter, const std::string& key, int fallbackVal) {
+  int estimate = counter.estimate(key);
+  return estimate ? estimate : fallbackVal;
+}
@@ -0,0 +1,191 @@
+/**
+ * @file StreamingWordCounter.h
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * Approximate word counting in a fixed amount of memory.
+ *
+**/
+
+#pragma once
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+#include "UnorderedMapCommon.h"
+
+// makeWordCounts keeps one map entry for every unique word, so its memory
+// use grows with the vocabulary. For an endless stream of words (such as
+// log messages), that could eventually use up all memory. The classes here
+// use a fixed amount of memory chosen up front, in exchange for answers
+// that are approximate, with error bounds that can be configured.
+
+// -------------------------------------------------------------------
+// CountMinSketch class
+// -------------------------------------------------------------------
+// A Count-Min Sketch is a table of counters with a few rows. Each row
+// uses a different hash function to choose one counter for each word, and
+// adding a word increases its counter in every row. Different words may
+// share a counter by chance, which can only make a count too high, never
+// too low. So the estimate for a word is the smallest of its counters.
+//
+// With width = ceil(e / epsilon) and depth = ceil(ln(1 / delta)) counters,
+// every estimate is at least the true count, and with probability at least
+// 1 - delta it is at most the true count plus epsilon times the total
+// number of words added.
+//
+// We use the "conservative update" rule: when adding, a counter is only
+// increased as far as needed to bring it up to the word's new estimate.
+// This keeps the same guarantee and makes the estimates noticeably tighter.
+class CountMinSketch {
+public:
+  CountMinSketch(double epsilon, double delta);
+
+  // Add occurrences of a word.
+  void add(const std::string& word, int count=1);
+
+  // Estimated number of occurrences of a word. This is never less than the
+  // true count, so 0 means the word was definitely never added.
+  int estimate(const std::string& word) const;
+
+  // Total number of occurrences added.
+  std::uint64_t total() const { return total_; }
+
+  std::size_t width() const { return width_; }
+  std::size_t depth() const { return depth_; }
+
+private:
+  std::size_t width_;
+  std::size_t depth_;
+  // depth_ rows of width_ counters each, stored row after row.
+  std::vector<int> counters_;
+  std::uint64_t total_;
+
+  // The two hashes of a word that choose its counter in every row.
+  struct WordHashes {
+    std::uint64_t h1;
+    std::uint64_t h2;
+  };
+  static WordHashes hashWord(const std::string& word);
+
+  // The index in counters_ of a word's counter in one row. This is cheap
+  // enough to compute again whenever it's needed, so nothing is allocated
+  // per word.
+  std::size_t counterIndex(const WordHashes& hashes, std::size_t row) const {
+    return row * width_ + static_cast<std::size_t>((hashes.h1 + row * hashes.h2) % width_);
+  }
+};
+
+// -------------------------------------------------------------------
+// SpaceSavingCounter class
+// -------------------------------------------------------------------
+// The Space-Saving algorithm keeps exact-looking counts for a fixed number
+// of words ("capacity"). When a word that isn't being tracked arrives and
+// there is no room left, it replaces the tracked word with the smallest
+// count, and inherits that count (plus one). That count is an overestimate,
+// and we remember by how much it could be too high.
+//
+// This guarantees that every word that makes up more than 1/capacity of all
+// the words seen is being tracked, and each tracked word's count is too high
+// by at most total/capacity. So the most frequent words are found reliably.
+class SpaceSavingCounter {
+public:
+  explicit SpaceSavingCounter(std::size_t capacity);
+
+  // Add one occurrence of a word.
+  void add(const std::string& word);
+
+  // Estimated count for a tracked word, or 0 if it isn't tracked.
+  int estimate(const std::string& word) const;
+
+  // How much a tracked word's estimate could be too high (0 if the word has
+  // been tracked since its first occurrence). Returns 0 if not tracked.
+  int maxError(const std::string& word) const;
+
+  // Up to max_words tracked words with the highest estimated counts, from
+  // highest to lowest. (Ties are listed in alphabetical order.)
+  StringIntPairVec top(unsigned int max_words=20) const;
+
+  std::size_t capacity() const { return capacity_; }
+  std::size_t size() const { return entries_.size(); }
+  std::uint64_t total() const { return total_; }
+
+private:
+  struct Entry {
+    std::string word;
+    // Counts saturate at the largest int rather than overflow.
+    int count;
+    int error;
+    // std::hash of the word, kept so the index never hashes it again.
+    std::size_t hash;
+    // Where this entry is in heap_.
+    std::size_t heapPosition;
+  };
+
+  static constexpr std::uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+
+  std::size_t capacity_;
+  std::uint64_t total_;
+  // The tracked words. Once an entry is added it stays at the same index;
+  // when a word is replaced, its entry is reused for the new word (and so
+  // is the string's buffer, when the new word fits in it).
+  std::vector<Entry> entries_;
+  // Indices of entries_, arranged as a binary min-heap by count, so the
+  // word to replace is always at the front. Moving an entry in the heap
+  // only moves this index and updates the entry's heapPosition.
+  std::vector<std::uint32_t> heap_;
+  // An open-addressing hash table from words to their entries: each slot
+  // holds an index of entries_, or EMPTY_SLOT. Collisions go to the next
+  // slot ("linear probing"). It has a fixed power-of-two number of slots,
+  // at least twice the capacity, so it never needs to grow or rehash.
+  std::vector<std::uint32_t> slots_;
+
+  // The slot holding the word's entry, or the empty slot where it would go.
+  std::size_t findSlot(const std::string& word, std::size_t hash) const;
+  // Remove the entry in a slot from the index, moving later entries back
+  // so that no lookup is cut short by the gap.
+  void eraseSlot(std::size_t slot);
+
+  // Restore the heap order after the count at this heap position increased,
+  // or after it was added at the end.
+  void siftDown(std::size_t position);
+  void siftUp(std::size_t position);
+  // Swap two heap positions and update their entries' heapPosition.
+  void swapHeapPositions(std::size_t a, std::size_t b);
+};
+
+// -------------------------------------------------------------------
+// StreamingWordCounter class
+// -------------------------------------------------------------------
+// Combines the two: The sketch answers point queries about any word, and
+// the Space-Saving counter finds the most frequent words. The memory used
+// depends only on the parameters given to the constructor.
+class StreamingWordCounter {
+public:
+  // epsilon and delta configure the sketch as described above, and
+  // heavyHitterCapacity is the number of words tracked for top().
+  StreamingWordCounter(double epsilon=0.0001, double delta=0.001, std::size_t heavyHitterCapacity=1000);
+
+  void add(const std::string& word);
+  void addAll(const StringVec& words);
+
+  // Estimated count for a word (never lower than the true count).
+  int estimate(const std::string& word) const { return sketch_.estimate(word); }
+
+  // Estimated most frequent words, from highest count to lowest.
+  StringIntPairVec top(unsigned int max_words=20) const { return heavyHitters_.top(max_words); }
+
+  std::uint64_t total() const { return sketch_.total(); }
+
+  const CountMinSketch& sketch() const { return sketch_; }
+  const SpaceSavingCounter& heavyHitters() const { return heavyHitters_; }
+
+private:
+  CountMinSketch sketch_;
+  SpaceSavingCounter heavyHitters_;
+};
+
+// A version of lookupWithFallback for a StreamingWordCounter: Returns the
+// estimated count, or fallbackVal if the word was definitely never seen.
+int lookupWithFallback(const StreamingWordCounter& counter, const std::string& key, int fallbackVal);
@@ -0,0 +1,178 @@
+/**
+ * @file StringInterner.cpp
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * Word counting with small integer IDs instead of strings.
+ *
+**/
+
+#include <algorithm> // for std::sort, std::lexicographical_compare, std::max
+#include <cstring> // for std::memcpy
+#include <functional> // for std::hash
+#include <stdexcept> // for std::length_error
+
+#include "StringInterner.h"
+#include "Instrumentation.h"
+
+// In some versions of C++ we have to redeclare constant static members
+// at global scope like this to ensure that the linker doesn't give an error.
+constexpr WordId StringInterner::NOT_FOUND;
+constexpr std::size_t StringInterner::BLOCK_SIZE;
+
+StringInterner::StringInterner() : blockUsed_(0), arenaBytes_(0), slots_(1024, 0) {}
+
+WordId StringInterner::find(const WordView& word) const {
+  const WordId slotValue = slots_[findSlot(word, std::hash<WordView>()(word))];
+  return slotValue ? slotValue - 1 : NOT_FOUND;
+}
+
+WordId StringInterner::intern(const WordView& word) {
+  const std::size_t hash = std::hash<WordView>()(word);
+  std::size_t slot = findSlot(word, hash);
+  if (slots_[slot]) {
+    return slots_[slot] - 1;
+  }
+
+  if (words_.size() >= NOT_FOUND - 1) {
+    throw std::length_error("StringInterner is full");
+  }
+  const WordId id = static_cast<WordId>(words_.size());
+  words_.push_back(WordView(store(word), word.length));
+  hashes_.push_back(hash);
+
+  // Keep the table at most half full, so searches stay short.
+  if (2 * words_.size() > slots_.size()) {
+    growTable();
+  }
+  else {
+    slots_[slot] = id + 1;
+  }
+  return id;
+}
+
+std::size_t StringInterner::findSlot(const WordView& word, std::size_t hash) const {
+  // Linear probing: try the following slots in order until we find the
+  // word or an empty slot. The table size is a power of two.
+  const std::size_t mask = slots_.size() - 1;
+  for (std::size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+    const WordId slotValue = slots_[slot];
+    if (!slotValue || (hashes_[slotValue - 1] == hash && words_[slotValue - 1] == word)) {
+      return slot;
+    }
+  }
+}
+
+void StringInterner::growTable() {
+  slots_.assign(slots_.size() * 2, 0);
+  const std::size_t mask = slots_.size() - 1;
+  for (WordId id = 0; id < words_.size(); id++) {
+    std::size_t slot = hashes_[id] & mask;
+    while (slots_[slot]) {
+      slot = (slot + 1) & mask;
+    }
+    slots_[slot] = id + 1;
+  }
+}
+
+const char* StringInterner::store(const WordView& word) {
+  if (blocks_.empty() || blockUsed_ + word.length > BLOCK_SIZE) {
+    // Start a new block. A word longer than a whole block gets a block of
+    // its own size.
+    const std::size_t blockSize = std::max(BLOCK_SIZE, word.length);
+    blocks_.emplace_back(new char[blockSize]);
+    blockUsed_ = 0;
+    arenaBytes_ += blockSize;
+  }
+  char* destination = blocks_.back().get() + blockUsed_;
+  if (word.length) {
+    std::memcpy(destination, word.data, word.length);
+  }
+  blockUsed_ += word.length;
+  return destination;
+}
+
+std::vector<WordId> StringInterner::alphabeticalRanks() const {
+  WordIdVec byWord(words_.size());
+  for (WordId id = 0; id < byWord.size(); id++) {
+    byWord[id] = id;
+  }
+  std::sort(byWord.begin(), byWord.end(), [this](WordId a, WordId b) {
+    const WordView& x = words_[a];
+    const WordView& y = words_[b];
+    return std::lexicographical_compare(x.data, x.data + x.length, y.data, y.data + y.length,
+      [](char p, char q) { return static_cast<unsigned char>(p) < static_cast<unsigned char>(q); });
+  });
+  std::vector<WordId> ranks(words_.size());
+  for (WordId rank = 0; rank < byWord.size(); rank++) {
+    ranks[byWord[rank]] = rank;
+  }
+  return ranks;
+}
+
+std::size_t StringInterner::memoryBytes() const {
+  return arenaBytes_ + words_.capacity() * sizeof(WordView) + hashes_.capacity() * sizeof(std::size_t)
+    + slots_.capacity() * sizeof(WordId);
+}
+
+// ========================================================================
+//   Word counting with IDs
+// ========================================================================
+
+WordIdVec internWords(const StringVec& words, StringInterner& interner) {
+  INSTRUMENT_SCOPE("internWords");
+  WordIdVec ids;
+  ids.reserve(words.size());
+  for (const std::string& word : words) {
+    ids.push_back(interner.intern(word));
+  }
+  return ids;
+}
+
+WordIdVec internWords(const std::vector<WordView>& words, StringInterner& interner) {
+  INSTRUMENT_SCOPE("internWords");
+  WordIdVec ids;
+  ids.reserve(words.size());
+  for (const WordView& word : words) {
+    ids.push_back(interner.intern(word));
+  }
+  return ids;
+}
+
+std::vector<int> countWordIds(const WordIdVec& ids, const StringInterner& interner) {
+  std::vector<int> counts(interner.size(), 0);
+  for (WordId id : ids) {
+    counts[id]++;
+  }
+  return counts;
+}
+
+StringIntMap wordCountsFromIds(const std::vector<int>& counts, const StringInterner& interner) {
+  StringIntMap wordcount_map;
+  wordcount_map.reserve(counts.size());
+  for (WordId id = 0; id < counts.size(); id++) {
+    if (counts[id]) {
+      wordcount_map[interner.str(id)] = counts[id];
+    }
+  }
+  return wordcount_map;
+}
+
+StringIntPairVec sortWordIdCounts(const std::vector<int>& counts, const StringInterner& interner) {
+  INSTRUMENT_SCOPE("sortWordIdCounts");
+  const std::vector<WordId> ranks = interner.alphabeticalRanks();
+  WordIdVec ids;
+  ids.reserve(counts.size());
+  for (WordId id = 0; id < counts.size(); id++) {
+    if (counts[id]) ids.push_back(id);
+  }
+  std::sort(ids.begin(), ids.end(), [&](WordId a, WordId b) {
+    return counts[a] < counts[b] || (counts[a] == counts[b] && ranks[a] < ranks[b]);
+  });
+
+  StringIntPairVec results;
+  results.reserve(ids.size());
+  for (WordId id : ids) {
+    results.push_back(StringIntPair(interner.str(id), counts[id]));
+  }
+  return results;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file StringInterner.h
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * Word counting with small integer IDs instead of strings.
+ *
+**/
+
+#pragma once
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint32_t
+#include <memory> // for std::unique_ptr
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+#include "UnorderedMapCommon.h"
+#include "WordView.h"
+
+// A word ID. IDs are given out in order 0, 1, 2, ... as new words are seen.
+using WordId = std::uint32_t;
+using WordIdVec = std::vector<WordId>;
+
+// -------------------------------------------------------------------
+// StringInterner class
+// -------------------------------------------------------------------
+// A StringVec from loadBookStrings has a separate std::string for every
+// occurrence of every word, so a common word like "alice" is stored hundreds
+// of times. Then every step of the word counting works with the full
+// strings again: makeWordCounts hashes each occurrence, and sorting compares
+// the characters of the words.
+//
+// "Interning" stores each unique word only once and gives it a small
+// integer ID. A text can then be kept as a vector of IDs (4 bytes per word),
+// and since the IDs are numbered densely from 0, counting can use a plain
+// vector indexed by ID instead of a hash table.
+//
+// The characters of the unique words are copied into large blocks of memory
+// (an "arena"), one after another, so there's no per-word allocation. The
+// blocks never move, so the WordView for an ID stays valid for as long as
+// the interner exists. A small open-addressing hash table finds the ID of a
+// word; each word is hashed only when it's interned.
+class StringInterner {
+public:
+  // The result of find() for a word that hasn't been interned.
+  static constexpr WordId NOT_FOUND = 0xFFFFFFFFu;
+
+  StringInterner();
+
+  // Disable copying, since the views handed out refer to our arena.
+  StringInterner(const StringInterner& other) = delete;
+  StringInterner& operator=(const StringInterner& other) = delete;
+
+  // The ID of a word, adding it if it's new.
+  WordId intern(const WordView& word);
+  WordId intern(const std::string& word) { return intern(WordView(word.data(), word.length())); }
+
+  // The ID of a word, or NOT_FOUND if it hasn't been interned.
+  WordId find(const WordView& word) const;
+  WordId find(const std::string& word) const { return find(WordView(word.data(), word.length())); }
+
+  // The characters of an interned word.
+  const WordView& view(WordId id) const { return words_[id]; }
+  std::string str(WordId id) const { return words_[id].str(); }
+
+  // Number of unique words, which is also the next ID to be given out.
+  std::size_t size() const { return words_.size(); }
+
+  // For each ID, its position among all the interned words in alphabetical
+  // order. Comparing ranks gives the same result as comparing the words.
+  std::vector<WordId> alphabeticalRanks() const;
+
+  // Approximate bytes of memory used, including the arena.
+  std::size_t memoryBytes() const;
+
+private:
+  static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+
+  // The arena: blockUsed_ bytes of the last block are in use.
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  std::size_t blockUsed_;
+  std::size_t arenaBytes_;
+  // The interned words and their hashes, indexed by ID.
+  std::vector<WordView> words_;
+  std::vector<std::size_t> hashes_;
+  // Hash table slots hold an ID plus 1, or 0 for an empty slot.
+  std::vector<WordId> slots_;
+
+  // Copy characters into the arena.
+  const char* store(const WordView& word);
+  // Index of the slot for the word, or of the empty slot where it belongs.
+  std::size_t findSlot(const WordView& word, std::size_t hash) const;
+  void growTable();
+};
+
+// -------------------------------------------------------------------
+// Word counting with IDs
+// -------------------------------------------------------------------
+
+// Convert words to IDs, interning any new words.
+WordIdVec internWords(const StringVec& words, StringInterner& interner);
+WordIdVec internWords(const std::vector<WordView>& words, StringInterner& interner);
+
+// Count the occurrences of each ID. The result has one count per interned
+// word, indexed by ID.
+std::vector<int> countWordIds(const WordIdVec& ids, const StringInterner& interner);
+
+// Convert ID counts back to the usual map from words to counts, giving the
+// same result as makeWordCounts. (Words with a count of 0 are left out.)
+StringIntMap wordCountsFromIds(const std::vector<int>& counts, const StringInterner& interner);
+
+// The same records as sortWordCounts, in order of increasing count. Words
+// with the same count are in alphabetical order. The sorting compares only
+// integers: the counts, and the alphabetical ranks of the IDs.
+StringIntPairVec sortWordIdCounts(const std::vector<int>& counts, const StringInterner& interner);
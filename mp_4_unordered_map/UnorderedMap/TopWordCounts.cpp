@@ -0,0 +1,168 @@
+/**
+ * @file TopWordCounts.cpp
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * Finding the most and least frequent words without sorting every count.
+ *
+**/
+
+#include <algorithm> // for std::push_heap, std::pop_heap, std::sort_heap, std::min
+#include <string> // for std::string
+#include <thread> // for std::thread
+#include <unordered_map> // for std::unordered_map
+#include <vector> // for std::vector
+
+#include "FlatStringIntMap.h"
+#include "TopWordCounts.h"
+
+// We select pointers to the map's entries, so that no strings are copied
+// until the final results are known.
+using EntryPtr = const StringIntMap::value_type*;
+
+// "Ranks before" relations for the two kinds of lists. Ties in the count are
+// broken alphabetically, so that every entry has a definite place.
+struct TopOrder {
+  bool operator()(EntryPtr x, EntryPtr y) const {
+    return x->second > y->second || (x->second == y->second && x->first < y->first);
+  }
+};
+
+struct BottomOrder {
+  bool operator()(EntryPtr x, EntryPtr y) const {
+    return x->second < y->second || (x->second == y->second && x->first < y->first);
+  }
+};
+
+// Keeps the best max_words entries offered to it. The entries are stored as
+// a heap ordered by rankBefore, which puts the lowest-ranked entry kept so
+// far at the front, where it can be compared and replaced quickly.
+template <typename Order>
+class BestEntries {
+public:
+  explicit BestEntries(std::size_t maxEntriesArg) : maxEntries(maxEntriesArg) {
+    heap.reserve(maxEntries);
+  }
+
+  void offer(EntryPtr entry) {
+    if (heap.size() < maxEntries) {
+      heap.push_back(entry);
+      std::push_heap(heap.begin(), heap.end(), rankBefore);
+    }
+    else if (maxEntries > 0 && rankBefore(entry, heap.front())) {
+      // The new entry beats the lowest-ranked one we had, so it takes its place.
+      std::pop_heap(heap.begin(), heap.end(), rankBefore);
+      heap.back() = entry;
+      std::push_heap(heap.begin(), heap.end(), rankBefore);
+    }
+  }
+
+  void offerAll(const BestEntries& other) {
+    for (EntryPtr entry : other.heap) {
+      offer(entry);
+    }
+  }
+
+  // Copy the kept entries in order, best first.
+  StringIntPairVec results() {
+    std::sort_heap(heap.begin(), heap.end(), rankBefore);
+    StringIntPairVec selected;
+    selected.reserve(heap.size());
+    for (EntryPtr entry : heap) {
+      selected.push_back(StringIntPair(entry->first, entry->second));
+    }
+    return selected;
+  }
+
+private:
+  std::size_t maxEntries;
+  std::vector<EntryPtr> heap;
+  Order rankBefore;
+};
+
+// Visit the entries of one shard of the map. For std::unordered_map, a shard
+// is a range of buckets; for FlatStringIntMap, it's a range of the entries.
+template <typename Visit>
+static void forEachInShard(const std::unordered_map<std::string, int>& wordcount_map,
+  std::size_t shard, std::size_t shardCount, Visit visit) {
+  const std::size_t buckets = wordcount_map.bucket_count();
+  for (std::size_t b = buckets * shard / shardCount; b < buckets * (shard + 1) / shardCount; b++) {
+    for (auto it = wordcount_map.begin(b); it != wordcount_map.end(b); it++) {
+      visit(*it);
+    }
+  }
+}
+
+template <typename Visit>
+static void forEachInShard(const FlatStringIntMap& wordcount_map,
+  std::size_t shard, std::size_t shardCount, Visit visit) {
+  const std::size_t entries = wordcount_map.size();
+  auto first = wordcount_map.begin();
+  for (std::size_t i = entries * shard / shardCount; i < entries * (shard + 1) / shardCount; i++) {
+    visit(first[i]);
+  }
+}
+
+template <typename Order>
+static StringIntPairVec selectWordCounts(const StringIntMap& wordcount_map, unsigned int max_words) {
+  BestEntries<Order> best(std::min<std::size_t>(max_words, wordcount_map.size()));
+  for (const auto& wordcount : wordcount_map) {
+    best.offer(&wordcount);
+  }
+  return best.results();
+}
+
+template <typename Order>
+static StringIntPairVec selectWordCountsParallel(const StringIntMap& wordcount_map, unsigned int max_words, unsigned int threadCount) {
+
+  // Below this many entries per thread, it's faster to stay on one thread.
+  constexpr std::size_t MIN_ENTRIES_PER_THREAD = 16 * 1024;
+
+  if (0 == threadCount) {
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+  }
+  std::size_t maxUsefulThreads = std::max<std::size_t>(1, wordcount_map.size() / MIN_ENTRIES_PER_THREAD);
+  std::size_t shardCount = std::min<std::size_t>(threadCount, maxUsefulThreads);
+  if (1 == shardCount) {
+    return selectWordCounts<Order>(wordcount_map, max_words);
+  }
+
+  const std::size_t maxEntries = std::min<std::size_t>(max_words, wordcount_map.size());
+  std::vector<BestEntries<Order>> shardBest(shardCount, BestEntries<Order>(maxEntries));
+  auto searchShard = [&](std::size_t shard) {
+    forEachInShard(wordcount_map, shard, shardCount, [&](const StringIntMap::value_type& wordcount) {
+      shardBest[shard].offer(&wordcount);
+    });
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t shard = 1; shard < shardCount; shard++) {
+    threads.emplace_back(searchShard, shard);
+  }
+  searchShard(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // The overall best entries must be among the best of some shard.
+  BestEntries<Order> best(maxEntries);
+  for (const auto& shardResult : shardBest) {
+    best.offerAll(shardResult);
+  }
+  return best.results();
+}
+
+StringIntPairVec getTopWordCountsFromMap(const StringIntMap& wordcount_map, unsigned int max_words) {
+  return selectWordCounts<TopOrder>(wordcount_map, max_words);
+}
+
+StringIntPairVec getBottomWordCountsFromMap(const StringIntMap& wordcount_map, unsigned int max_words) {
+  return selectWordCounts<BottomOrder>(wordcount_map, max_words);
+}
+
+StringIntPairVec getTopWordCountsParallel(const StringIntMap& wordcount_map, unsigned int max_words, unsigned int threadCount) {
+  return selectWordCountsParallel<TopOrder>(wordcount_map, max_words, threadCount);
+}
+
+StringIntPairVec getBottomWordCountsParallel(const StringIntMap& wordcount_map, unsigned int max_words, unsigned int threadCount) {
+  return selectWordCountsParallel<BottomOrder>(wordcount_map, max_words, threadCount);
+}
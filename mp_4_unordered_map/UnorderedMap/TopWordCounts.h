@@ -0,0 +1,33 @@
+/**
+ * @file TopWordCounts.h
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * Finding the most and least frequent words without sorting every count.
+ *
+**/
+
+#pragma once
+
+#include "UnorderedMapCommon.h"
+
+// getTopWordCounts and getBottomWordCounts take the result of sortWordCounts,
+// which copies every entry of the map into a vector and sorts all of them,
+// even though only a few are wanted. These functions select the top or
+// bottom max_words entries directly from the map instead. They keep the
+// best entries found so far in a heap of at most max_words items, so for
+// n unique words they take O(n log max_words) time, and only the selected
+// entries are copied.
+//
+// The top list is ordered by count from highest to lowest, and the bottom
+// list from lowest to highest. Unlike the lists made from sortWordCounts,
+// words with equal counts are always listed in alphabetical order, so the
+// results don't depend on the order of the map.
+StringIntPairVec getTopWordCountsFromMap(const StringIntMap& wordcount_map, unsigned int max_words=20);
+StringIntPairVec getBottomWordCountsFromMap(const StringIntMap& wordcount_map, unsigned int max_words=20);
+
+// Parallel versions of the above: The map is split into shards that are
+// searched on separate threads, each keeping its own heap, and then the
+// per-shard results are merged. If threadCount is 0, one thread is used per
+// hardware core. The results are the same as for the serial versions.
+StringIntPairVec getTopWordCountsParallel(const StringIntMap& wordcount_map, unsigned int max_words=20, unsigned int threadCount=0);
+StringIntPairVec getBottomWordCountsParallel(const StringIntMap& wordcount_map, unsigned int max_words=20, unsigned int threadCount=0);
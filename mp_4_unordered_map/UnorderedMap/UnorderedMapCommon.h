@@ -21,6 +21,7 @@
 #include <utility> // for std::pair
 #include <unordered_map> // for std::unordered_map
 #include <chrono> // for std::chrono::high_resolution_clock
+#include <stdexcept> // for std::runtime_error
 
 // ------------------------------------------------------------------------
 //  About the timer code
@@ -66,7 +67,16 @@ static double getMilliDuration(T start_time, T stop_time) {
 // (We are just making alternative, shorter names for these STL types.)
 using StringVec = std::vector<std::string>;
 using StringIntPair = std::pair<std::string, int>;
+// (If USE_FLAT_STRING_INT_MAP is defined when compiling, for example with
+//  "make CS400=-DUSE_FLAT_STRING_INT_MAP", StringIntMap is instead our own
+//  open-addressing hash table from FlatStringIntMap.h, which supports the
+//  same operations that the word counting code uses.)
+#ifdef USE_FLAT_STRING_INT_MAP
+#include "FlatStringIntMap.h"
+using StringIntMap = FlatStringIntMap;
+#else
 using StringIntMap = std::unordered_map<std::string, int>;
+#endif
 using StringIntPairVec = std::vector<StringIntPair>;
 
 // The palindrome exercise involves pairs of integer indices, and in particular,
@@ -80,7 +90,15 @@ using StringIntPairVec = std::vector<StringIntPair>;
 // for more explanation about that). It maps a pair of int indices to an int
 // palindrome length. This is meant to represent the maximum length of any
 // palindrome substring found between the given indices.
+// (If USE_DENSE_LENGTH_MEMO is defined when compiling, LengthMemo is instead
+//  the array-based table from IntervalMemo.h, which stores one int for every
+//  interval and finds it without hashing.)
+#ifdef USE_DENSE_LENGTH_MEMO
+#include "IntervalMemo.h"
+using LengthMemo = IntervalMemo<int>;
+#else
 using LengthMemo = std::unordered_map<IntPair, int>;
+#endif
 
 // Load the whole book "Through the Looking-Glass" as vector of strings.
 // (This is handled for you.)
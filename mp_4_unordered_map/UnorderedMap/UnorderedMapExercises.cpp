@@ -57,11 +57,9 @@ StringIntMap makeWordCounts(const StringVec& words) {
   // EXERCISE 1 WORKSPACE: YOUR CODE HERE
   // =================================================
   for(const auto& word : words) {
-    if(!wordcount_map.count(word)) {
-      wordcount_map[word] = 1;
-    } else {
-      wordcount_map[word]++;
-    }
+    // The [] operator inserts a missing key with the value 0, so a single
+    // lookup both creates and increments the count.
+    wordcount_map[word]++;
   }
   return wordcount_map;
 }
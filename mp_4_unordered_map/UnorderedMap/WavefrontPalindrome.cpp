@@ -0,0 +1,194 @@
+/**
+ * @file WavefrontPalindrome.cpp
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * Multi-threaded evaluation of the palindrome memoization table.
+ *
+**/
+
+#include <algorithm> // for std::min, std::max
+#include <atomic> // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <cstdint> // for std::int16_t
+#include <functional> // for std::ref
+#include <limits> // for std::numeric_limits
+#include <mutex> // for std::mutex, std::unique_lock
+#include <stdexcept> // for std::length_error
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+
+#include "WavefrontPalindrome.h"
+#include "Instrumentation.h"
+
+// The number of lefts and rights covered by one tile. A tile's columns are
+// TILE_SIZE cells each, so with int cells the few columns a tile works on
+// at once take a couple of kilobytes.
+static constexpr int TILE_SIZE = 128;
+
+// -------------------------------------------------------------------
+// DiagonalBarrier class
+// -------------------------------------------------------------------
+// Makes the threads wait until all of them have finished the current
+// diagonal of tiles before any of them starts the next one.
+//
+// The threads also have to agree on whether to stop. If each thread decided
+// that for itself after the barrier, one that was released early could
+// start the next diagonal, run out of time, and say so before a thread
+// released later had looked, and then they'd disagree: the late thread
+// would stop, and the others would wait for it at the next barrier forever.
+// So each thread passes in whether it wants to stop, and the last thread to
+// arrive decides for everyone while holding the mutex.
+class DiagonalBarrier {
+public:
+  explicit DiagonalBarrier(unsigned int threadCount)
+    : threadCount_(threadCount), waiting_(0), generation_(0), stopRequested_(false), stopDecided_(false) {}
+
+  // Returns true if any thread asked to stop on this diagonal. Every thread
+  // gets the same answer.
+  bool arriveAndWait(bool stop) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const unsigned int generation = generation_;
+    stopRequested_ = stopRequested_ || stop;
+    if (++waiting_ == threadCount_) {
+      // No thread can arrive at the next barrier until this thread has
+      // too, so stopDecided_ can't change before the others have read it.
+      stopDecided_ = stopRequested_;
+      stopRequested_ = false;
+      waiting_ = 0;
+      generation_++;
+      allArrived_.notify_all();
+    }
+    else {
+      allArrived_.wait(lock, [&] { return generation != generation_; });
+    }
+    return stopDecided_;
+  }
+
+private:
+  const unsigned int threadCount_;
+  unsigned int waiting_;
+  unsigned int generation_;
+  bool stopRequested_;
+  bool stopDecided_;
+  std::mutex mutex_;
+  std::condition_variable allArrived_;
+};
+
+// Everything the threads share.
+template <typename Cell>
+struct WavefrontJob {
+  IntervalMemo<Cell>& memo;
+  const std::string& str;
+  int tileCount;
+  unsigned int threadCount;
+  timeUnit startTime;
+  double maxDuration;
+  DiagonalBarrier barrier;
+  // Set by any thread that notices the time limit has passed. The others
+  // may check it to give up on their tiles sooner, but whether to stop is
+  // decided by the barrier.
+  std::atomic<bool> tooSlow;
+
+  WavefrontJob(IntervalMemo<Cell>& memo, const std::string& str, int tileCount, unsigned int threadCount,
+    timeUnit startTime, double maxDuration)
+    : memo(memo), str(str), tileCount(tileCount), threadCount(threadCount),
+      startTime(startTime), maxDuration(maxDuration), barrier(threadCount), tooSlow(false) {}
+};
+
+// Compute the intervals with left in tile row tileLeft and right in tile
+// column tileRight (only those with left < right; the shorter intervals
+// were filled in beforehand). Within the tile we go column by column, and
+// up each column from the main diagonal, so every interval's subproblems
+// are ready when we get to it.
+template <typename Cell>
+static void computeTile(IntervalMemo<Cell>& memo, const std::string& str, int tileLeft, int tileRight) {
+  const int n = str.length();
+  const int leftBegin = tileLeft * TILE_SIZE;
+  const int leftEnd = std::min(n, leftBegin + TILE_SIZE);
+  const int rightBegin = tileRight * TILE_SIZE;
+  const int rightEnd = std::min(n, rightBegin + TILE_SIZE);
+  const char* s = str.data();
+
+  for (int right = rightBegin; right < rightEnd; right++) {
+    Cell* current = memo.column(right);
+    const Cell* previous = memo.column(right-1);
+    for (int left = std::min(right-1, leftEnd-1); left >= leftBegin; left--) {
+      const int middleMaxLength = right-left-1;
+      if (s[left] == s[right] && previous[left+1] == middleMaxLength) {
+        current[left] = static_cast<Cell>(middleMaxLength + 2);
+      }
+      else {
+        current[left] = std::max(previous[left], current[left+1]);
+      }
+    }
+  }
+}
+
+// The work of one thread: on each diagonal of tiles, compute every
+// threadCount-th tile starting from threadIndex, then wait for the others.
+template <typename Cell>
+static void runWavefrontThread(WavefrontJob<Cell>& job, unsigned int threadIndex) {
+  for (int diagonal = 0; diagonal < job.tileCount; diagonal++) {
+    // The tiles on this diagonal are (tileLeft, tileLeft + diagonal).
+    const int tilesOnDiagonal = job.tileCount - diagonal;
+    bool stop = false;
+    for (int tileLeft = threadIndex; tileLeft < tilesOnDiagonal; tileLeft += job.threadCount) {
+      // Checking the clock once per tile is plenty often.
+      if (job.tooSlow || getMilliDuration(job.startTime, getTimeNow()) > job.maxDuration) {
+        job.tooSlow = true;
+        stop = true;
+        break;
+      }
+      computeTile(job.memo, job.str, tileLeft, tileLeft + diagonal);
+    }
+    if (job.barrier.arriveAndWait(stop)) return;
+  }
+}
+
+template <typename Cell>
+int wavefrontLongestPalindromeLength(IntervalMemo<Cell>& memo, const std::string& str, timeUnit startTime, double maxDuration, unsigned int threadCount) {
+  INSTRUMENT_SCOPE("wavefrontLongestPalindromeLength");
+  const int n = str.length();
+  if (static_cast<long long>(n) > static_cast<long long>(std::numeric_limits<Cell>::max())) {
+    throw std::length_error("wavefrontLongestPalindromeLength: string too long for the memo's cell type");
+  }
+
+  // Make room for every interval, then fill in the empty and
+  // single-character intervals, which don't depend on anything.
+  memo.reserveColumns(n);
+  memo.column(-1)[0] = 0;
+  for (int right = 0; right < n; right++) {
+    memo.column(right)[right+1] = 0;
+    memo.column(right)[right] = 1;
+  }
+
+  const int tileCount = (n + TILE_SIZE - 1) / TILE_SIZE;
+  if (0 == threadCount) {
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+  }
+  // The longest diagonal has tileCount tiles, so more threads than that
+  // would never have anything to do.
+  threadCount = std::max(1u, std::min<unsigned int>(threadCount, tileCount));
+
+  WavefrontJob<Cell> job(memo, str, tileCount, threadCount, startTime, maxDuration);
+  std::vector<std::thread> threads;
+  threads.reserve(threadCount - 1);
+  for (unsigned int threadIndex = 1; threadIndex < threadCount; threadIndex++) {
+    threads.emplace_back(runWavefrontThread<Cell>, std::ref(job), threadIndex);
+  }
+  runWavefrontThread(job, 0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  memo.recount();
+  if (job.tooSlow) {
+    throw TooSlowException("taking too long");
+  }
+  return memo.column(n-1)[0];
+}
+
+// The template is defined here rather than in the header, so we have to
+// list the versions that other files can use.
+template int wavefrontLongestPalindromeLength(IntervalMemo<int>& memo, const std::string& str, timeUnit startTime, double maxDuration, unsigned int threadCount);
+template int wavefrontLongestPalindromeLength(IntervalMemo<std::int16_t>& memo, const std::string& str, timeUnit startTime, double maxDuration, unsigned int threadCount);
@@ -0,0 +1,42 @@
+/**
+ * @file WavefrontPalindrome.h
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * Multi-threaded evaluation of the palindrome memoization table.
+ *
+**/
+
+#pragma once
+
+#include <string> // for std::string
+
+#include "UnorderedMapCommon.h"
+#include "IntervalMemo.h"
+
+// wavefrontLongestPalindromeLength fills in the memoization table for every
+// interval of str, like tabulateLongestPalindromeLengths, but splits the
+// work across several threads. It returns the longest palindrome length for
+// the whole string, and afterward reconstructPalindromeFromMemo (or
+// reconstructPalindrome, if LengthMemo is an IntervalMemo) can find it.
+//
+// The answer for an interval only depends on shorter intervals inside it:
+// (left+1, right-1), (left, right-1) and (left+1, right). So the table can
+// be computed as a "wavefront". We cut the triangle of intervals into square
+// tiles of TILE_SIZE lefts by TILE_SIZE rights. A tile only depends on the
+// tiles just below it and to its left, which are one diagonal of tiles
+// closer to the main diagonal. So all the tiles on one diagonal can be
+// computed at the same time, and the threads only need to wait for each
+// other between diagonals.
+//
+// The tiles also keep the work cache-friendly: a tile reads and writes
+// TILE_SIZE-cell runs of a few neighboring columns, which all fit in the
+// cache at once, instead of sweeping over the whole table for every column.
+//
+// If threadCount is 0, one thread is used per hardware core. Like
+// memoizedLongestPalindromeLength, this throws TooSlowException if it runs
+// longer than maxDuration milliseconds after startTime. It throws
+// std::length_error if the string is too long for the memo's Cell type.
+//
+// (This is defined for IntervalMemo<int> and IntervalMemo<std::int16_t>.)
+template <typename Cell>
+int wavefrontLongestPalindromeLength(IntervalMemo<Cell>& memo, const std::string& str, timeUnit startTime, double maxDuration, unsigned int threadCount=0);
@@ -0,0 +1,275 @@
+/**
+ * @file WordCountIndex.cpp
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * Word counts saved in a file that can be searched without loading it.
+ *
+**/
+
+#include <algorithm> // for std::sort, std::min
+#include <cstdio> // for std::rename, std::remove
+#include <cstdlib> // for mkstemp
+#include <cstring> // for std::memcmp
+#include <fstream> // for std::ofstream
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::runtime_error, std::out_of_range
+#include <utility> // for std::pair
+#include <vector> // for std::vector
+
+// POSIX headers for memory-mapping files
+#include <fcntl.h> // for open
+#include <sys/mman.h> // for mmap, munmap
+#include <sys/stat.h> // for fstat, stat, fchmod
+#include <unistd.h> // for close
+
+#include "WordCountIndex.h"
+#include "Instrumentation.h"
+
+// In some versions of C++ we have to redeclare constant static members
+// at global scope like this to ensure that the linker doesn't give an error.
+constexpr std::uint32_t WordCountIndexHeader::MAGIC;
+constexpr std::uint32_t WordCountIndexHeader::VERSION;
+
+// Compare two words the same way std::string's < operator does: byte by
+// byte as unsigned values, and a shorter word first if one is the start of
+// the other. Returns a negative number, zero, or a positive number.
+static int compareWords(const char* a, std::size_t aLength, const char* b, std::size_t bLength) {
+  const std::size_t commonLength = std::min(aLength, bLength);
+  const int result = commonLength ? std::memcmp(a, b, commonLength) : 0;
+  if (result) return result;
+  return (aLength < bLength) ? -1 : (aLength > bLength) ? 1 : 0;
+}
+
+static bool wordViewLess(const WordView& x, const WordView& y) {
+  return compareWords(x.data, x.length, y.data, y.length) < 0;
+}
+
+using WordViewCount = std::pair<WordView, int>;
+
+// Write an index file from entries that are already sorted by word. The
+// file should be a new one that nobody else has open.
+static void writeSortedEntries(const std::vector<WordViewCount>& sorted, const std::string& filename) {
+  WordCountIndexHeader header;
+  header.magic = WordCountIndexHeader::MAGIC;
+  header.version = WordCountIndexHeader::VERSION;
+  header.entryCount = sorted.size();
+  header.stringBytes = 0;
+
+  std::vector<WordCountIndexEntry> entries;
+  entries.reserve(sorted.size());
+  for (const WordViewCount& wc : sorted) {
+    if (wc.first.length > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::runtime_error("Word too long for a word count index");
+    }
+    entries.push_back(WordCountIndexEntry{header.stringBytes, static_cast<std::uint32_t>(wc.first.length), wc.second});
+    header.stringBytes += wc.first.length;
+  }
+
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error("Could not open word count index file for writing: " + filename);
+  }
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (!entries.empty()) {
+    file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(WordCountIndexEntry));
+  }
+  for (const WordViewCount& wc : sorted) {
+    file.write(wc.first.data, wc.first.length);
+  }
+  file.close();
+  if (!file) {
+    throw std::runtime_error("Could not write word count index file: " + filename);
+  }
+}
+
+// Save an index file from entries that are already sorted by word,
+// replacing the file if it exists. The new version is written to a
+// temporary file next to it, which is then renamed into place. Renaming
+// only changes which file the name refers to, so any process that has the
+// old file mapped keeps reading the old version. (Truncating the old file
+// and writing over it would make the mapped pages disappear, and the next
+// lookup would crash.) Each call gets its own temporary file, so two merges
+// at the same time can't write over each other's, though the last rename
+// wins.
+static void replaceIndexFile(const std::vector<WordViewCount>& sorted, const std::string& filename) {
+  std::string tempFilename = filename + ".XXXXXX";
+  const int fd = mkstemp(&tempFilename[0]);
+  if (fd < 0) {
+    throw std::runtime_error("Could not create a temporary file for word count index file: " + filename);
+  }
+  // mkstemp only gives the owner access, but an index file should be
+  // readable like any other file we write.
+  fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  close(fd);
+
+  try {
+    writeSortedEntries(sorted, tempFilename);
+  }
+  catch (...) {
+    std::remove(tempFilename.c_str());
+    throw;
+  }
+  if (std::rename(tempFilename.c_str(), filename.c_str()) != 0) {
+    std::remove(tempFilename.c_str());
+    throw std::runtime_error("Could not replace word count index file: " + filename);
+  }
+}
+
+// The words of a map with nonzero counts, in alphabetical order. The views
+// refer to the map's keys.
+static std::vector<WordViewCount> sortedMapEntries(const StringIntMap& wordcount_map) {
+  std::vector<WordViewCount> sorted;
+  sorted.reserve(wordcount_map.size());
+  for (const auto& wc : wordcount_map) {
+    if (wc.second) {
+      sorted.push_back(WordViewCount(WordView(wc.first.data(), wc.first.length()), wc.second));
+    }
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const WordViewCount& x, const WordViewCount& y) {
+    return wordViewLess(x.first, y.first);
+  });
+  return sorted;
+}
+
+// ========================================================================
+//   WordCountIndex
+// ========================================================================
+
+WordCountIndex::WordCountIndex(const std::string& filename) : mapping_(nullptr), mappingBytes_(0) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Could not open word count index file: " + filename);
+  }
+  struct stat fileInfo;
+  if (fstat(fd, &fileInfo) != 0) {
+    close(fd);
+    throw std::runtime_error("Could not open word count index file: " + filename);
+  }
+  const std::size_t fileBytes = static_cast<std::size_t>(fileInfo.st_size);
+  if (fileBytes < sizeof(WordCountIndexHeader)) {
+    close(fd);
+    throw std::runtime_error("Not a word count index file: " + filename);
+  }
+
+  void* mapping = mmap(nullptr, fileBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (MAP_FAILED == mapping) {
+    throw std::runtime_error("Could not map word count index file: " + filename);
+  }
+  mapping_ = static_cast<const char*>(mapping);
+  mappingBytes_ = fileBytes;
+
+  // Check that the header makes sense and that every entry refers to
+  // characters inside the file, so lookups never read past the end.
+  const WordCountIndexHeader& h = header();
+  const std::uint64_t maxEntries = (fileBytes - sizeof(WordCountIndexHeader)) / sizeof(WordCountIndexEntry);
+  bool valid = WordCountIndexHeader::MAGIC == h.magic && WordCountIndexHeader::VERSION == h.version
+    && h.entryCount <= maxEntries
+    && sizeof(WordCountIndexHeader) + h.entryCount * sizeof(WordCountIndexEntry) + h.stringBytes == fileBytes;
+  for (std::size_t i = 0; valid && i < size(); i++) {
+    const WordCountIndexEntry& entry = entries()[i];
+    valid = entry.offset <= h.stringBytes && entry.length <= h.stringBytes - entry.offset;
+  }
+  if (!valid) {
+    munmap(const_cast<char*>(mapping_), mappingBytes_);
+    throw std::runtime_error("Not a valid word count index file: " + filename);
+  }
+}
+
+WordCountIndex::~WordCountIndex() {
+  munmap(const_cast<char*>(mapping_), mappingBytes_);
+}
+
+WordView WordCountIndex::word(std::size_t position) const {
+  const WordCountIndexEntry& entry = entries()[position];
+  return WordView(stringBytes() + entry.offset, entry.length);
+}
+
+std::size_t WordCountIndex::findPosition(const std::string& key) const {
+  // Binary search for the first entry that isn't less than the key.
+  std::size_t low = 0;
+  std::size_t high = size();
+  while (low < high) {
+    const std::size_t middle = low + (high - low) / 2;
+    const WordView middleWord = word(middle);
+    if (compareWords(middleWord.data, middleWord.length, key.data(), key.length()) < 0) {
+      low = middle + 1;
+    }
+    else {
+      high = middle;
+    }
+  }
+  return (low < size() && word(low) == key) ? low : size();
+}
+
+int WordCountIndex::at(const std::string& key) const {
+  const std::size_t position = findPosition(key);
+  if (size() == position) {
+    throw std::out_of_range("WordCountIndex::at: word not found");
+  }
+  return countAt(position);
+}
+
+StringIntMap WordCountIndex::toMap() const {
+  StringIntMap wordcount_map;
+  wordcount_map.reserve(size());
+  for (std::size_t i = 0; i < size(); i++) {
+    wordcount_map[word(i).str()] = countAt(i);
+  }
+  return wordcount_map;
+}
+
+void WordCountIndex::write(const StringIntMap& wordcount_map, const std::string& filename) {
+  INSTRUMENT_SCOPE("WordCountIndex::write");
+  replaceIndexFile(sortedMapEntries(wordcount_map), filename);
+}
+
+void WordCountIndex::merge(const std::string& filename, const StringIntMap& delta) {
+  INSTRUMENT_SCOPE("WordCountIndex::merge");
+  const std::vector<WordViewCount> sortedDelta = sortedMapEntries(delta);
+
+  struct stat fileInfo;
+  if (stat(filename.c_str(), &fileInfo) != 0) {
+    // There's no index yet, so the delta is the whole index.
+    replaceIndexFile(sortedDelta, filename);
+    return;
+  }
+
+  const WordCountIndex old(filename);
+
+  // Merge the two sorted lists, adding the counts of words found in both.
+  std::vector<WordViewCount> merged;
+  merged.reserve(old.size() + sortedDelta.size());
+  std::size_t oldPosition = 0;
+  auto deltaIt = sortedDelta.begin();
+  while (oldPosition < old.size() || deltaIt != sortedDelta.end()) {
+    if (deltaIt == sortedDelta.end() || (oldPosition < old.size() && wordViewLess(old.word(oldPosition), deltaIt->first))) {
+      merged.push_back(WordViewCount(old.word(oldPosition), old.countAt(oldPosition)));
+      oldPosition++;
+    }
+    else if (oldPosition == old.size() || wordViewLess(deltaIt->first, old.word(oldPosition))) {
+      merged.push_back(*deltaIt);
+      deltaIt++;
+    }
+    else {
+      const long long sum = static_cast<long long>(old.countAt(oldPosition)) + deltaIt->second;
+      if (sum > std::numeric_limits<int>::max() || sum < std::numeric_limits<int>::min()) {
+        throw std::runtime_error("Word count overflow while merging into " + filename);
+      }
+      if (sum) {
+        merged.push_back(WordViewCount(old.word(oldPosition), static_cast<int>(sum)));
+      }
+      oldPosition++;
+      deltaIt++;
+    }
+  }
+
+  // (The old file stays mapped until "old" goes away, which is fine, since
+  // the new version goes into a different file.)
+  replaceIndexFile(merged, filename);
+}
+
+int lookupWithFallback(const WordCountIndex& index, const std::string& key, int fallbackVal) {
+  const std::size_t position = index.findPosition(key);
+  return (index.size() == position) ? fallbackVal : index.countAt(position);
+}
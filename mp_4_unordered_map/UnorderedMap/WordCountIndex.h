@@ -0,0 +1,122 @@
+/**
+ * @file WordCountIndex.h
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * Word counts saved in a file that can be searched without loading it.
+ *
+**/
+
+#pragma once
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint32_t, std::uint64_t, std::int32_t
+#include <string> // for std::string
+
+#include "UnorderedMapCommon.h"
+#include "WordView.h"
+
+// Every run of the word counting code starts over from the text: it loads
+// the book and counts every word again. A WordCountIndex file saves the
+// counts instead, so later runs (or other programs) can look words up
+// straight from the file, and new text can be added to the counts without
+// recounting everything that came before.
+//
+// The file is a "sorted string table":
+//
+//   WordCountIndexHeader
+//   WordCountIndexEntry[entryCount], sorted by word
+//   stringBytes bytes holding the characters of all the words
+//
+// Each entry holds a word's count and where its characters are. The file is
+// memory-mapped for reading, so opening it doesn't read or copy anything,
+// and a lookup is a binary search over the entries that only touches the
+// few pages it needs. Numbers are stored in the computer's native byte
+// order, so files should be read on the same kind of computer that wrote
+// them.
+
+struct WordCountIndexHeader {
+  // Identifies the file format: the characters "WCIX".
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint64_t entryCount;
+  std::uint64_t stringBytes;
+
+  static constexpr std::uint32_t MAGIC = 0x58494357u; // "WCIX" in little-endian
+  static constexpr std::uint32_t VERSION = 1;
+};
+
+struct WordCountIndexEntry {
+  // Where the word's characters start, counting from the beginning of the
+  // string bytes.
+  std::uint64_t offset;
+  std::uint32_t length;
+  std::int32_t count;
+};
+
+// -------------------------------------------------------------------
+// WordCountIndex class
+// -------------------------------------------------------------------
+// An open, read-only index file. The file is checked when it's opened,
+// and std::runtime_error is thrown if it can't be read or isn't valid.
+
+class WordCountIndex {
+public:
+  explicit WordCountIndex(const std::string& filename);
+
+  // Disable copying, since this object owns the mapping.
+  WordCountIndex(const WordCountIndex& other) = delete;
+  WordCountIndex& operator=(const WordCountIndex& other) = delete;
+
+  ~WordCountIndex();
+
+  // Number of words in the index.
+  std::size_t size() const { return static_cast<std::size_t>(header().entryCount); }
+  bool empty() const { return 0 == size(); }
+
+  // The word and count at a position, in alphabetical order. The word
+  // refers to the mapped file, so it's only valid while this object exists.
+  WordView word(std::size_t position) const;
+  int countAt(std::size_t position) const { return entries()[position].count; }
+
+  // The position of a word, or size() if it isn't in the index.
+  std::size_t findPosition(const std::string& word) const;
+
+  // Returns 1 if the word is in the index, and 0 otherwise.
+  std::size_t count(const std::string& word) const { return (size() != findPosition(word)) ? 1 : 0; }
+
+  // The count for a word that must be in the index. Throws std::out_of_range
+  // otherwise, like std::unordered_map::at.
+  int at(const std::string& word) const;
+
+  // Copy the whole index into an ordinary map.
+  StringIntMap toMap() const;
+
+  // Save word counts as an index file, replacing the file if it exists.
+  // Words with a count of 0 are left out. Like merge, this writes a
+  // temporary file that then replaces the old one, so any WordCountIndex
+  // that is still open keeps seeing the old version.
+  static void write(const StringIntMap& wordcount_map, const std::string& filename);
+
+  // Add the counts in delta to the index file, creating the file if it
+  // doesn't exist yet. Only the index's entries and the words in delta are
+  // visited, by merging the two sorted lists, so nothing is recounted. A
+  // word whose count becomes 0 is removed. The new index is written to a
+  // temporary file that then replaces the old one, so the file is never
+  // left half-written, and any WordCountIndex that is still open keeps
+  // seeing the old version.
+  static void merge(const std::string& filename, const StringIntMap& delta);
+
+private:
+  const char* mapping_;
+  std::size_t mappingBytes_;
+
+  const WordCountIndexHeader& header() const { return *reinterpret_cast<const WordCountIndexHeader*>(mapping_); }
+  const WordCountIndexEntry* entries() const {
+    return reinterpret_cast<const WordCountIndexEntry*>(mapping_ + sizeof(WordCountIndexHeader));
+  }
+  const char* stringBytes() const { return reinterpret_cast<const char*>(entries() + size()); }
+};
+
+// A version of lookupWithFallback for an index file: Returns the word's
+// count, or fallbackVal if the word isn't in the index.
+int lookupWithFallback(const WordCountIndex& index, const std::string& key, int fallbackVal);
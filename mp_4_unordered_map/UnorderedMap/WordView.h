@@ -0,0 +1,66 @@
+/**
+ * @file WordView.h
+ * University of Illinois CS 400, MOOC 3, Week 1: Unordered Map
+ *
+ * A lightweight, non-owning reference to a word stored elsewhere.
+ *
+**/
+
+#pragma once
+
+#include <cstddef> // for std::size_t
+#include <cstring> // for std::memcmp
+#include <functional> // for std::hash
+#include <ostream> // for std::ostream
+#include <string> // for std::string
+
+// A WordView refers to a run of characters that is owned by some other
+// object, such as a memory-mapped file (see MappedBook.h). It is just a
+// pointer and a length, so copying one never allocates memory or copies
+// the characters. (This is similar to std::string_view from C++17, which
+// isn't available in the C++14 standard that this project uses.)
+//
+// A WordView is only valid while the characters it refers to still exist.
+struct WordView {
+  const char* data;
+  std::size_t length;
+
+  WordView() : data(nullptr), length(0) {}
+  WordView(const char* dataArg, std::size_t lengthArg) : data(dataArg), length(lengthArg) {}
+
+  // Make an owning std::string copy of the characters.
+  std::string str() const { return std::string(data, length); }
+
+  bool operator==(const WordView& other) const {
+    return length == other.length && (0 == length || 0 == std::memcmp(data, other.data, length));
+  }
+  bool operator!=(const WordView& other) const { return !(*this == other); }
+
+  bool operator==(const std::string& other) const {
+    return length == other.length() && (0 == length || 0 == std::memcmp(data, other.data(), length));
+  }
+  bool operator!=(const std::string& other) const { return !(*this == other); }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const WordView& word) {
+  return os.write(word.data, word.length);
+}
+
+// As in IntPair.h, we specialize std::hash so that WordView can be used as
+// a key in std::unordered_map and std::unordered_set. We hash the characters
+// directly with the FNV-1a algorithm, so no temporary std::string is needed.
+namespace std {
+
+  template <>
+  struct hash<WordView> {
+    std::size_t operator() (const WordView& word) const {
+      std::size_t h = static_cast<std::size_t>(14695981039346656037ULL);
+      for (std::size_t i = 0; i < word.length; i++) {
+        h ^= static_cast<unsigned char>(word.data[i]);
+        h *= static_cast<std::size_t>(1099511628211ULL);
+      }
+      return h;
+    }
+  };
+
+}
@@ -5,13 +5,33 @@
 // Based on Catch2 unit testing framework
 
 #include <cstdlib>
+#include <cstdio>
 #include <stdexcept>
 #include <sstream>
+#include <fstream>
 #include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <random>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 
 #include "../uiuc/catch/catch.hpp"
 
 #include "../UnorderedMapCommon.h"
+#include "../ParallelWordCount.h"
+#include "../MappedBook.h"
+#include "../FlatStringIntMap.h"
+#include "../TopWordCounts.h"
+#include "../StreamingWordCounter.h"
+#include "../PalindromeSolvers.h"
+#include "../IntervalMemo.h"
+#include "../WavefrontPalindrome.h"
+#include "../StringInterner.h"
+#include "../WordCountIndex.h"
+#include "../Instrumentation.h"
 
 // May be useful in writing some tests
 template <typename T>
@@ -161,3 +181,1094 @@ TEST_CASE("Testing memoizedLongestPalindromeLength: Memoization table should be
   }
 
 }
+
+// ========================================================================
+// Tests: makeWordCountsParallel
+// ========================================================================
+
+TEST_CASE("Testing makeWordCountsParallel", "[weight=0]") {
+
+  constexpr int MIN_WORD_LENGTH = 5;
+  const StringVec bookstrings = loadBookStrings(MIN_WORD_LENGTH);
+
+  // Repeat the book so that each thread gets a real shard to count.
+  StringVec manystrings;
+  for (int i = 0; i < 8; i++) {
+    manystrings.insert(manystrings.end(), bookstrings.begin(), bookstrings.end());
+  }
+
+  const StringIntMap expected = makeWordCounts(manystrings);
+
+  SECTION("Should match makeWordCounts for any number of threads") {
+    for (unsigned int threads : {1u, 2u, 3u, 8u}) {
+      REQUIRE(makeWordCountsParallel(manystrings, threads) == expected);
+    }
+  }
+
+  SECTION("Should handle small and empty inputs") {
+    REQUIRE(makeWordCountsParallel(StringVec{"dog", "cat", "dog"}, 4) == StringIntMap{{"cat", 1}, {"dog", 2}});
+    REQUIRE(makeWordCountsParallel(StringVec(), 4).empty());
+  }
+
+}
+
+// This is hidden because of the [.] tag.
+// You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: makeWordCountsParallel scaling", "[weight=0][.][bench]") {
+
+  constexpr int MIN_WORD_LENGTH = 5;
+  constexpr int REPEATS = 100;
+  const StringVec bookstrings = loadBookStrings(MIN_WORD_LENGTH);
+  StringVec manystrings;
+  for (int i = 0; i < REPEATS; i++) {
+    manystrings.insert(manystrings.end(), bookstrings.begin(), bookstrings.end());
+  }
+
+  std::cout << std::endl << "Counting " << manystrings.size() << " words:" << std::endl;
+  {
+    auto start_time = getTimeNow();
+    auto wordcount_map = makeWordCounts(manystrings);
+    auto stop_time = getTimeNow();
+    std::cout << "makeWordCounts: " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+  }
+  const unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned int threads = 1; ; threads *= 2) {
+    threads = std::min(threads, maxThreads);
+    auto start_time = getTimeNow();
+    auto wordcount_map = makeWordCountsParallel(manystrings, threads);
+    auto stop_time = getTimeNow();
+    std::cout << "makeWordCountsParallel with " << threads << " thread(s): "
+      << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+    if (threads == maxThreads) break;
+  }
+
+}
+
+// ========================================================================
+// Tests: MappedBook
+// ========================================================================
+
+TEST_CASE("Testing MappedBook", "[weight=0]") {
+
+  SECTION("Should load the same words as loadBookStrings") {
+    for (unsigned int min_word_length : {1u, 5u, 9u}) {
+      MappedBook book(min_word_length);
+      REQUIRE(book.toStringVec() == loadBookStrings(min_word_length));
+    }
+  }
+
+  SECTION("Should follow the apostrophe and hyphen rules") {
+    std::string text = "Alice\xE2\x80\x99s looking-glass--house isn't 'here'--or-- -there- a''b";
+    std::vector<WordView> words;
+    MappedBook::tokenizeInPlace(&text[0], &text[0] + text.size(), 1, words);
+    StringVec strings;
+    for (const WordView& word : words) strings.push_back(word.str());
+    const StringVec expected = {"alice's", "looking-glass", "house", "isn't", "here", "or", "there", "ab"};
+    REQUIRE(strings == expected);
+  }
+
+  SECTION("Should report a missing file") {
+    REQUIRE_THROWS_AS(MappedBook(5, "no_such_book.txt"), std::runtime_error);
+  }
+
+}
+
+// This is hidden because of the [.] tag.
+// You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: loadBookStrings vs. MappedBook", "[weight=0][.][bench]") {
+
+  constexpr int MIN_WORD_LENGTH = 5;
+  std::cout << std::endl << "Loading the book:" << std::endl;
+  {
+    auto start_time = getTimeNow();
+    StringVec bookstrings = loadBookStrings(MIN_WORD_LENGTH);
+    auto stop_time = getTimeNow();
+    std::cout << "loadBookStrings: " << getMilliDuration(start_time, stop_time) << "ms ("
+      << bookstrings.size() << " words)" << std::endl;
+  }
+  {
+    auto start_time = getTimeNow();
+    MappedBook book(MIN_WORD_LENGTH);
+    auto stop_time = getTimeNow();
+    std::cout << "MappedBook: " << getMilliDuration(start_time, stop_time) << "ms ("
+      << book.words().size() << " words)" << std::endl;
+  }
+
+}
+
+// ========================================================================
+// Tests: FlatStringIntMap
+// ========================================================================
+
+// Count words into any map type that supports operator[].
+template <typename Map>
+Map countWordsInto(const StringVec& words) {
+  Map counts;
+  for (const auto& word : words) {
+    counts[word]++;
+  }
+  return counts;
+}
+
+TEST_CASE("Testing FlatStringIntMap", "[weight=0]") {
+
+  SECTION("Should count the book the same as std::unordered_map") {
+    const StringVec bookstrings = loadBookStrings(1);
+    const auto expected = countWordsInto<std::unordered_map<std::string, int>>(bookstrings);
+    const auto counts = countWordsInto<FlatStringIntMap>(bookstrings);
+    REQUIRE(counts.size() == expected.size());
+    for (const auto& wordcount : expected) {
+      REQUIRE(counts.count(wordcount.first) == 1);
+      REQUIRE(counts.at(wordcount.first) == wordcount.second);
+    }
+    REQUIRE(counts.load_factor() <= 0.875f);
+  }
+
+  SECTION("Should support lookups, erasing, and comparison") {
+    FlatStringIntMap counts{{"cat", 1}, {"dog", 2}};
+    REQUIRE(counts.count("dog") == 1);
+    REQUIRE(counts.count("cheshire") == 0);
+    REQUIRE(counts.find("cheshire") == counts.end());
+    REQUIRE_THROWS_AS(counts.at("cheshire"), std::out_of_range);
+
+    for (int i = 0; i < 1000; i++) {
+      counts["key" + std::to_string(i)] = i;
+    }
+    for (int i = 0; i < 1000; i += 2) {
+      REQUIRE(counts.erase("key" + std::to_string(i)) == 1);
+    }
+    REQUIRE(counts.erase("key0") == 0);
+    REQUIRE(counts.size() == 502);
+    for (int i = 0; i < 1000; i++) {
+      REQUIRE(counts.count("key" + std::to_string(i)) == static_cast<std::size_t>(i % 2));
+    }
+    REQUIRE(counts.at("key999") == 999);
+
+    FlatStringIntMap same{{"dog", 2}, {"cat", 1}};
+    for (int i = 999; i >= 0; i -= 2) {
+      same["key" + std::to_string(i)] = i;
+    }
+    REQUIRE(counts == same);
+    same["cat"]++;
+    REQUIRE(counts != same);
+
+    counts.clear();
+    REQUIRE(counts.empty());
+    REQUIRE(counts.count("dog") == 0);
+  }
+
+}
+
+// This is hidden because of the [.] tag.
+// You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: std::unordered_map vs. FlatStringIntMap", "[weight=0][.][bench]") {
+
+  // A synthetic input with a skewed vocabulary, like real text: word i of
+  // the vocabulary is chosen with probability roughly proportional to 1/i.
+  constexpr int SYNTHETIC_TOKENS = 10000000;
+  constexpr int VOCABULARY = 200000;
+  StringVec synthetic;
+  synthetic.reserve(SYNTHETIC_TOKENS);
+  {
+    std::mt19937 rng(400);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for (int i = 0; i < SYNTHETIC_TOKENS; i++) {
+      int rank = static_cast<int>(std::pow(static_cast<double>(VOCABULARY), uniform(rng)));
+      synthetic.push_back("word" + std::to_string(rank));
+    }
+  }
+
+  StringVec book = loadBookStrings(1);
+  for (const StringVec* input : {&book, &synthetic}) {
+    std::cout << std::endl << "Counting " << input->size() << " "
+      << (input == &book ? "book" : "synthetic") << " tokens:" << std::endl;
+    {
+      auto start_time = getTimeNow();
+      auto counts = countWordsInto<std::unordered_map<std::string, int>>(*input);
+      auto stop_time = getTimeNow();
+      std::cout << "std::unordered_map: " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+    }
+    {
+      auto start_time = getTimeNow();
+      auto counts = countWordsInto<FlatStringIntMap>(*input);
+      auto stop_time = getTimeNow();
+      std::cout << "FlatStringIntMap: " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+    }
+  }
+
+}
+
+// ========================================================================
+// Tests: getTopWordCountsFromMap and getBottomWordCountsFromMap
+// ========================================================================
+
+// The expected top or bottom list, made by fully sorting the map.
+static StringIntPairVec sortedPrefix(const StringIntMap& wordcount_map, unsigned int max_words, bool top) {
+  StringIntPairVec all(wordcount_map.begin(), wordcount_map.end());
+  std::sort(all.begin(), all.end(), [top](const StringIntPair& x, const StringIntPair& y) {
+    if (x.second != y.second) return top ? (x.second > y.second) : (x.second < y.second);
+    return x.first < y.first;
+  });
+  if (all.size() > max_words) all.resize(max_words);
+  return all;
+}
+
+TEST_CASE("Testing top and bottom word counts without sorting", "[weight=0]") {
+
+  const StringIntMap wordcount_map = makeWordCounts(loadBookStrings(5));
+
+  SECTION("Should agree with the lists made from sortWordCounts") {
+    const StringIntPairVec sorted = sortWordCounts(wordcount_map);
+    const StringIntPairVec top = getTopWordCountsFromMap(wordcount_map, 20);
+    const StringIntPairVec oldTop = getTopWordCounts(sorted, 20);
+    REQUIRE(top.size() == 20);
+    REQUIRE(top[0] == StringIntPair("alice", 434));
+    for (std::size_t i = 0; i < top.size(); i++) {
+      REQUIRE(top[i].second == oldTop[i].second);
+    }
+    const StringIntPairVec bottom = getBottomWordCountsFromMap(wordcount_map, 20);
+    for (const auto& wordcount : bottom) {
+      REQUIRE(wordcount.second == 1);
+    }
+  }
+
+  SECTION("Should break ties alphabetically") {
+    for (unsigned int k : {0u, 1u, 20u, 500u, 100000u}) {
+      REQUIRE(getTopWordCountsFromMap(wordcount_map, k) == sortedPrefix(wordcount_map, k, true));
+      REQUIRE(getBottomWordCountsFromMap(wordcount_map, k) == sortedPrefix(wordcount_map, k, false));
+    }
+  }
+
+  SECTION("Parallel versions should give the same results") {
+    StringIntMap large_map;
+    std::mt19937 rng(400);
+    for (int i = 0; i < 100000; i++) {
+      large_map["word" + std::to_string(i)] = static_cast<int>(rng() % 1000);
+    }
+    const StringIntPairVec top = getTopWordCountsFromMap(large_map, 50);
+    const StringIntPairVec bottom = getBottomWordCountsFromMap(large_map, 50);
+    REQUIRE(top == sortedPrefix(large_map, 50, true));
+    for (unsigned int threads : {1u, 2u, 3u, 8u}) {
+      REQUIRE(getTopWordCountsParallel(large_map, 50, threads) == top);
+      REQUIRE(getBottomWordCountsParallel(large_map, 50, threads) == bottom);
+    }
+  }
+
+}
+
+// This is hidden because of the [.] tag.
+// You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: top 20 words by sorting vs. selecting", "[weight=0][.][bench]") {
+
+  constexpr int UNIQUE_WORDS = 1000000;
+  StringIntMap wordcount_map;
+  std::mt19937 rng(400);
+  for (int i = 0; i < UNIQUE_WORDS; i++) {
+    wordcount_map["word" + std::to_string(i)] = static_cast<int>(rng() % 100000);
+  }
+
+  std::cout << std::endl << "Top 20 of " << UNIQUE_WORDS << " unique words:" << std::endl;
+  {
+    auto start_time = getTimeNow();
+    auto top = getTopWordCounts(sortWordCounts(wordcount_map), 20);
+    auto stop_time = getTimeNow();
+    std::cout << "sortWordCounts + getTopWordCounts: " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+  }
+  {
+    auto start_time = getTimeNow();
+    auto top = getTopWordCountsFromMap(wordcount_map, 20);
+    auto stop_time = getTimeNow();
+    std::cout << "getTopWordCountsFromMap: " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+  }
+  {
+    auto start_time = getTimeNow();
+    auto top = getTopWordCountsParallel(wordcount_map, 20);
+    auto stop_time = getTimeNow();
+    std::cout << "getTopWordCountsParallel: " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+  }
+
+}
+
+// ========================================================================
+// Tests: StreamingWordCounter
+// ========================================================================
+
+TEST_CASE("Testing StreamingWordCounter", "[weight=0]") {
+
+  const StringVec bookstrings = loadBookStrings(5);
+  const StringIntMap exact = makeWordCounts(bookstrings);
+
+  constexpr double EPSILON = 0.001;
+  constexpr std::size_t CAPACITY = 200;
+  StreamingWordCounter counter(EPSILON, 0.001, CAPACITY);
+  counter.addAll(bookstrings);
+  REQUIRE(counter.total() == bookstrings.size());
+
+  SECTION("Sketch estimates should be within the error bound") {
+    const double maxError = EPSILON * bookstrings.size();
+    int withinBound = 0;
+    for (const auto& wordcount : exact) {
+      const int estimate = counter.estimate(wordcount.first);
+      REQUIRE(estimate >= wordcount.second);
+      if (estimate - wordcount.second <= maxError) withinBound++;
+    }
+    // The bound holds for each word with probability at least 1 - delta.
+    REQUIRE(withinBound >= 0.99 * exact.size());
+  }
+
+  SECTION("Point queries should work like lookupWithFallback") {
+    REQUIRE(lookupWithFallback(counter, "alice", 0) >= 434);
+    REQUIRE(lookupWithFallback(counter, "cheshire", -1) == -1);
+  }
+
+  SECTION("Frequent words should all be found with bounded error") {
+    const SpaceSavingCounter& heavyHitters = counter.heavyHitters();
+    REQUIRE(heavyHitters.size() == CAPACITY);
+    for (const auto& wordcount : exact) {
+      const int estimate = heavyHitters.estimate(wordcount.first);
+      if (wordcount.second * CAPACITY > bookstrings.size()) {
+        REQUIRE(estimate > 0);
+      }
+      if (estimate > 0) {
+        REQUIRE(estimate >= wordcount.second);
+        REQUIRE(estimate - heavyHitters.maxError(wordcount.first) <= wordcount.second);
+      }
+    }
+    const StringIntPairVec top = counter.top(5);
+    const StringIntPairVec exactTop = getTopWordCountsFromMap(exact, 5);
+    REQUIRE(top.size() == 5);
+    REQUIRE(top[0].first == "alice");
+    for (std::size_t i = 0; i < top.size(); i++) {
+      REQUIRE(top[i].first == exactTop[i].first);
+    }
+  }
+
+  SECTION("Replacing words should keep every tracked word findable") {
+    // A small capacity, so nearly every new word replaces another one.
+    SpaceSavingCounter small(7);
+    for (const std::string& word : bookstrings) {
+      small.add(word);
+    }
+    REQUIRE(small.size() == 7);
+    REQUIRE(small.total() == bookstrings.size());
+    // Each word added raises exactly one count by one.
+    std::uint64_t countSum = 0;
+    for (const auto& wordcount : small.top(7)) {
+      REQUIRE(small.estimate(wordcount.first) == wordcount.second);
+      countSum += wordcount.second;
+    }
+    REQUIRE(countSum == small.total());
+  }
+
+  SECTION("Bad parameters should be rejected") {
+    REQUIRE_THROWS_AS(CountMinSketch(0.0, 0.5), std::runtime_error);
+    REQUIRE_THROWS_AS(SpaceSavingCounter(0), std::runtime_error);
+  }
+
+}
+
+// ========================================================================
+// Tests: manacherLongestPalindromeSpan
+// ========================================================================
+
+// A random string over a small alphabet, which has plenty of palindromes.
+static std::string randomPalindromeTestString(std::mt19937& rng, int length, char maxLetter) {
+  std::string str;
+  for (int i = 0; i < length; i++) {
+    str += static_cast<char>('a' + rng() % (maxLetter - 'a' + 1));
+  }
+  return str;
+}
+
+TEST_CASE("Testing manacherLongestPalindromeSpan", "[weight=0]") {
+
+  SECTION("Should find the palindrome from the memoization example") {
+    const std::string str = "abbbcdeeeefgABCBAz";
+    const PalindromeSpan span = manacherLongestPalindromeSpan(str, 0, str.length()-1);
+    REQUIRE(span.length == 5);
+    REQUIRE(str.substr(span.left, span.length) == "ABCBA");
+    REQUIRE(findLongestPalindrome(str) == "ABCBA");
+    REQUIRE(findLongestPalindrome("") == "");
+    REQUIRE(findLongestPalindrome("xyzzyabba") == "yzzy");
+  }
+
+  SECTION("Should agree with memoizedLongestPalindromeLength for every range") {
+    std::mt19937 rng(400);
+    for (int trial = 0; trial < 30; trial++) {
+      const std::string str = randomPalindromeTestString(rng, 1 + trial % 20, 'c');
+      const int n = str.length();
+      LengthMemo memo;
+      for (int left = 0; left < n; left++) {
+        for (int right = left; right < n; right++) {
+          const PalindromeSpan span = manacherLongestPalindromeSpan(str, left, right);
+          REQUIRE(span.length == memoizedLongestPalindromeLength(memo, str, left, right, getTimeNow(), 10000.0));
+          // The span must be inside the limits and actually be a palindrome.
+          REQUIRE(span.left >= left);
+          REQUIRE(span.left + span.length - 1 <= right);
+          const std::string found = str.substr(span.left, span.length);
+          REQUIRE(found == std::string(found.rbegin(), found.rend()));
+        }
+      }
+    }
+  }
+
+  SECTION("Should check the limits") {
+    REQUIRE(manacherLongestPalindromeLength("abc", 2, 1) == 0);
+    REQUIRE_THROWS_AS(manacherLongestPalindromeLength("abc", -1, 1), std::runtime_error);
+    REQUIRE_THROWS_AS(manacherLongestPalindromeLength("abc", 0, 3), std::out_of_range);
+  }
+
+}
+
+// This is hidden because of the [.] tag.
+// You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: longest palindrome in a 100k-character string", "[weight=0][.][bench]") {
+
+  constexpr int LENGTH = 100000;
+  std::mt19937 rng(400);
+  const std::string str = randomPalindromeTestString(rng, LENGTH, 'b');
+
+  std::cout << std::endl << "Longest palindrome in " << LENGTH << " characters:" << std::endl;
+  auto start_time = getTimeNow();
+  const PalindromeSpan span = manacherLongestPalindromeSpan(str, 0, LENGTH-1);
+  auto stop_time = getTimeNow();
+  std::cout << "Manacher: length " << span.length << " in " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+
+}
+
+// ========================================================================
+// Tests: IntervalMemo
+// ========================================================================
+
+TEST_CASE("Testing IntervalMemo", "[weight=0]") {
+
+  SECTION("Should act like an unordered_map for interval keys") {
+    IntervalMemo<std::int16_t> memo;
+    REQUIRE(memo.empty());
+    REQUIRE(memo.count(std::make_pair(0, 3)) == 0);
+    REQUIRE_THROWS_AS(memo.at(std::make_pair(0, 3)), std::out_of_range);
+
+    // operator[] inserts 0 for a missing interval, and the table grows as
+    // needed without losing earlier entries.
+    REQUIRE(memo[std::make_pair(1, 2)] == 0);
+    memo[std::make_pair(1, 2)] = 7;
+    memo[std::make_pair(3, 2)] = 0;
+    memo[std::make_pair(0, 500)] = 42;
+    REQUIRE(memo.size() == 3);
+    REQUIRE(memo.count(std::make_pair(1, 2)) == 1);
+    REQUIRE(memo.at(std::make_pair(1, 2)) == 7);
+    REQUIRE(memo.count(std::make_pair(3, 2)) == 1);
+    REQUIRE(memo.at(std::make_pair(0, 500)) == 42);
+    REQUIRE(memo.count(std::make_pair(1, 500)) == 0);
+
+    // Only intervals (0 <= left <= right+1) can be keys.
+    REQUIRE(memo.count(std::make_pair(4, 2)) == 0);
+    REQUIRE(memo.count(std::make_pair(-1, 2)) == 0);
+    REQUIRE_THROWS_AS(memo[std::make_pair(4, 2)], std::out_of_range);
+
+    memo.clear();
+    REQUIRE(memo.empty());
+    REQUIRE(memo.count(std::make_pair(1, 2)) == 0);
+  }
+
+  SECTION("Should store every interval of a sequence exactly once") {
+    constexpr int N = 40;
+    IntervalMemo<int> memo(N);
+    const std::size_t reservedBytes = memo.memoryBytes();
+    int next = 0;
+    for (int right = -1; right < N; right++) {
+      for (int left = 0; left <= right+1; left++) {
+        memo[std::make_pair(left, right)] = next++;
+      }
+    }
+    REQUIRE(memo.size() == static_cast<std::size_t>(next));
+    REQUIRE(memo.memoryBytes() == reservedBytes);
+    next = 0;
+    for (int right = -1; right < N; right++) {
+      for (int left = 0; left <= right+1; left++) {
+        REQUIRE(memo.at(std::make_pair(left, right)) == next++);
+      }
+    }
+  }
+
+  SECTION("Should work as the palindrome memoization table") {
+    const std::string str = "abbbcdeeeefgABCBAz";
+
+    // (LengthMemo is an IntervalMemo when built with USE_DENSE_LENGTH_MEMO.)
+    LengthMemo memo;
+    REQUIRE(memoizedLongestPalindromeLength(memo, str, 0, str.length()-1, getTimeNow(), 10000.0) == 5);
+    REQUIRE(reconstructPalindrome(memo, str) == "ABCBA");
+    REQUIRE(reconstructPalindromeFromMemo(memo, str) == "ABCBA");
+
+    IntervalMemo<std::int16_t> smallMemo;
+    REQUIRE(tabulateLongestPalindromeLengths(smallMemo, str) == 5);
+    REQUIRE(reconstructPalindromeFromMemo(smallMemo, str) == "ABCBA");
+
+    LengthMemo hashMemo;
+    REQUIRE(tabulateLongestPalindromeLengths(hashMemo, str) == 5);
+    REQUIRE(reconstructPalindrome(hashMemo, str) == "ABCBA");
+    REQUIRE(reconstructPalindromeFromMemo(hashMemo, str) == "ABCBA");
+
+    REQUIRE(tabulateLongestPalindromeLengths(smallMemo, "") == 0);
+    REQUIRE(reconstructPalindromeFromMemo(smallMemo, "") == "");
+  }
+
+  SECTION("Should agree with memoizedLongestPalindromeLength for every range") {
+    std::mt19937 rng(40);
+    for (int trial = 0; trial < 30; trial++) {
+      const std::string str = randomPalindromeTestString(rng, 1 + trial % 20, 'c');
+      const int n = str.length();
+      IntervalMemo<std::int16_t> table;
+      tabulateLongestPalindromeLengths(table, str);
+      LengthMemo memo;
+      for (int left = 0; left < n; left++) {
+        for (int right = left; right < n; right++) {
+          REQUIRE(table.at(std::make_pair(left, right)) == memoizedLongestPalindromeLength(memo, str, left, right, getTimeNow(), 10000.0));
+        }
+      }
+      const PalindromeSpan span = manacherLongestPalindromeSpan(str, 0, n-1);
+      REQUIRE(reconstructPalindromeFromMemo(table, str).length() == static_cast<std::size_t>(span.length));
+    }
+  }
+
+  SECTION("Should refuse strings too long for the cell type") {
+    IntervalMemo<std::int8_t> tinyMemo;
+    REQUIRE_THROWS_AS(tabulateLongestPalindromeLengths(tinyMemo, std::string(200, 'a')), std::length_error);
+  }
+
+}
+
+// This is hidden because of the [.] tag.
+// You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: LengthMemo vs. IntervalMemo", "[weight=0][.][bench]") {
+
+  constexpr int LENGTH = 1000;
+  std::mt19937 rng(40);
+  const std::string str = randomPalindromeTestString(rng, LENGTH, 'b');
+
+  std::cout << std::endl << "Filling the palindrome table for " << LENGTH << " characters:" << std::endl;
+
+  auto start_time = getTimeNow();
+  LengthMemo hashMemo;
+  const int hashResult = tabulateLongestPalindromeLengths(hashMemo, str);
+  auto stop_time = getTimeNow();
+  std::cout << "std::unordered_map: " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+
+  start_time = getTimeNow();
+  IntervalMemo<int> intMemo;
+  const int intResult = tabulateLongestPalindromeLengths(intMemo, str);
+  stop_time = getTimeNow();
+  std::cout << "IntervalMemo<int>: " << getMilliDuration(start_time, stop_time) << "ms, "
+    << intMemo.memoryBytes() / 1024 << " KB" << std::endl;
+
+  start_time = getTimeNow();
+  IntervalMemo<std::int16_t> shortMemo;
+  const int shortResult = tabulateLongestPalindromeLengths(shortMemo, str);
+  stop_time = getTimeNow();
+  std::cout << "IntervalMemo<int16_t>: " << getMilliDuration(start_time, stop_time) << "ms, "
+    << shortMemo.memoryBytes() / 1024 << " KB" << std::endl;
+
+  REQUIRE(hashResult == intResult);
+  REQUIRE(hashResult == shortResult);
+
+}
+
+// ========================================================================
+// Tests: wavefrontLongestPalindromeLength
+// ========================================================================
+
+TEST_CASE("Testing wavefrontLongestPalindromeLength", "[weight=0]") {
+
+  SECTION("Should fill in the same table as tabulateLongestPalindromeLengths") {
+    std::mt19937 rng(41);
+    // Lengths around the tile size, so partial tiles are covered.
+    for (int length : {0, 1, 2, 127, 128, 129, 300, 700}) {
+      const std::string str = randomPalindromeTestString(rng, length, 'b');
+      IntervalMemo<int> expected;
+      const int expectedResult = tabulateLongestPalindromeLengths(expected, str);
+      for (unsigned int threads : {1u, 2u, 3u, 8u}) {
+        IntervalMemo<std::int16_t> memo;
+        REQUIRE(wavefrontLongestPalindromeLength(memo, str, getTimeNow(), 10000.0, threads) == expectedResult);
+        REQUIRE(memo.size() == expected.size());
+        bool allMatch = true;
+        for (int right = 0; right < length; right++) {
+          for (int left = 0; left <= right; left++) {
+            allMatch = allMatch && (memo.at(std::make_pair(left, right)) == expected.at(std::make_pair(left, right)));
+          }
+        }
+        REQUIRE(allMatch);
+        REQUIRE(reconstructPalindromeFromMemo(memo, str) == reconstructPalindromeFromMemo(expected, str));
+      }
+    }
+  }
+
+  SECTION("Should find the palindrome from the memoization example") {
+    const std::string str = "abbbcdeeeefgABCBAz";
+    IntervalMemo<int> memo;
+    REQUIRE(wavefrontLongestPalindromeLength(memo, str, getTimeNow(), 10000.0, 2) == 5);
+    REQUIRE(reconstructPalindromeFromMemo(memo, str) == "ABCBA");
+  }
+
+  SECTION("Should stop when it takes too long") {
+    std::mt19937 rng(41);
+    const std::string str = randomPalindromeTestString(rng, 1000, 'b');
+    IntervalMemo<int> memo;
+    REQUIRE_THROWS_AS(wavefrontLongestPalindromeLength(memo, str, getTimeNow(), -1.0, 3), TooSlowException);
+  }
+
+  SECTION("Should stop cleanly when the time runs out partway through") {
+    // With these limits, the threads usually run out of time on different
+    // diagonals. They all have to stop together, or this never returns.
+    std::mt19937 rng(41);
+    const std::string str = randomPalindromeTestString(rng, 3000, 'b');
+    IntervalMemo<int> expected;
+    const int expectedResult = tabulateLongestPalindromeLengths(expected, str);
+    for (double maxDuration = 0.0; maxDuration <= 40.0; maxDuration += 2.0) {
+      IntervalMemo<std::int16_t> memo;
+      // Timing out is expected for the shorter limits, but if it finishes,
+      // the answer has to be right.
+      int result = expectedResult;
+      try {
+        result = wavefrontLongestPalindromeLength(memo, str, getTimeNow(), maxDuration, 8);
+      }
+      catch (const TooSlowException&) {}
+      REQUIRE(result == expectedResult);
+    }
+  }
+
+}
+
+// This is hidden because of the [.] tag.
+// You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: serial vs. wavefront palindrome table", "[weight=0][.][bench]") {
+
+  constexpr int LENGTH = 4000;
+  std::mt19937 rng(41);
+  const std::string str = randomPalindromeTestString(rng, LENGTH, 'b');
+  const unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << std::endl << "Filling the palindrome table for " << LENGTH << " characters:" << std::endl;
+
+  auto start_time = getTimeNow();
+  IntervalMemo<std::int16_t> serialMemo;
+  const int serialResult = tabulateLongestPalindromeLengths(serialMemo, str);
+  auto stop_time = getTimeNow();
+  std::cout << "tabulateLongestPalindromeLengths: " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+
+  for (unsigned int threads : {1u, hardwareThreads}) {
+    start_time = getTimeNow();
+    IntervalMemo<std::int16_t> memo;
+    const int result = wavefrontLongestPalindromeLength(memo, str, start_time, 100000.0, threads);
+    stop_time = getTimeNow();
+    std::cout << "wavefront with " << threads << " thread(s): " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+    REQUIRE(result == serialResult);
+  }
+
+}
+
+// ========================================================================
+// Tests: StringInterner
+// ========================================================================
+
+TEST_CASE("Testing StringInterner", "[weight=0]") {
+
+  SECTION("Should give each unique word one dense ID") {
+    StringInterner interner;
+    REQUIRE(interner.intern("dog") == 0);
+    REQUIRE(interner.intern("cat") == 1);
+    REQUIRE(interner.intern(std::string("dog")) == 0);
+    REQUIRE(interner.intern("") == 2);
+    REQUIRE(interner.size() == 3);
+    REQUIRE(interner.find("cat") == 1);
+    REQUIRE(interner.find("bird") == StringInterner::NOT_FOUND);
+    REQUIRE(interner.str(0) == "dog");
+    REQUIRE(interner.view(2).length == 0);
+  }
+
+  SECTION("Should keep views valid while growing") {
+    StringInterner interner;
+    const WordView first = interner.view(interner.intern("first"));
+    std::vector<std::string> words;
+    for (int i = 0; i < 50000; i++) {
+      words.push_back("word" + std::to_string(i));
+      REQUIRE(interner.intern(words.back()) == static_cast<WordId>(i + 1));
+    }
+    // One word longer than an arena block.
+    const std::string longWord(100000, 'x');
+    const WordId longId = interner.intern(longWord);
+    REQUIRE(first == std::string("first"));
+    REQUIRE(interner.str(longId) == longWord);
+    for (int i = 0; i < 50000; i++) {
+      REQUIRE(interner.find(words[i]) == static_cast<WordId>(i + 1));
+    }
+  }
+
+  SECTION("Should rank words alphabetically") {
+    StringInterner interner;
+    for (const char* word : {"pear", "apple", "zoo", "apples", "Zebra"}) {
+      interner.intern(word);
+    }
+    const std::vector<WordId> ranks = interner.alphabeticalRanks();
+    REQUIRE(ranks == std::vector<WordId>({3, 1, 4, 2, 0}));
+  }
+
+  SECTION("Should count the book the same way as makeWordCounts") {
+    constexpr int MIN_WORD_LENGTH = 5;
+    const StringVec bookstrings = loadBookStrings(MIN_WORD_LENGTH);
+    const StringIntMap expected = makeWordCounts(bookstrings);
+
+    StringInterner interner;
+    const WordIdVec ids = internWords(bookstrings, interner);
+    REQUIRE(ids.size() == bookstrings.size());
+    REQUIRE(interner.size() == expected.size());
+    const std::vector<int> counts = countWordIds(ids, interner);
+    REQUIRE(wordCountsFromIds(counts, interner) == expected);
+
+    // The words from MappedBook get the same IDs.
+    MappedBook book(MIN_WORD_LENGTH);
+    REQUIRE(internWords(book.words(), interner) == ids);
+
+    const StringIntPairVec sorted = sortWordIdCounts(counts, interner);
+    REQUIRE(sorted.size() == expected.size());
+    for (std::size_t i = 1; i < sorted.size(); i++) {
+      const bool inOrder = sorted[i-1].second < sorted[i].second
+        || (sorted[i-1].second == sorted[i].second && sorted[i-1].first < sorted[i].first);
+      REQUIRE(inOrder);
+    }
+    REQUIRE(sorted.back().second == sortWordCounts(expected).back().second);
+  }
+
+}
+
+// This is hidden because of the [.] tag.
+// You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: counting strings vs. interned IDs", "[weight=0][.][bench]") {
+
+  constexpr int MIN_WORD_LENGTH = 5;
+  const StringVec bookstrings = loadBookStrings(MIN_WORD_LENGTH);
+  StringVec manystrings;
+  for (int i = 0; i < 20; i++) {
+    manystrings.insert(manystrings.end(), bookstrings.begin(), bookstrings.end());
+  }
+
+  std::cout << std::endl << "Counting and sorting " << manystrings.size() << " words:" << std::endl;
+
+  auto start_time = getTimeNow();
+  const StringIntPairVec sortedStrings = sortWordCounts(makeWordCounts(manystrings));
+  auto stop_time = getTimeNow();
+  std::cout << "makeWordCounts + sortWordCounts: " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+
+  start_time = getTimeNow();
+  StringInterner interner;
+  const WordIdVec ids = internWords(manystrings, interner);
+  stop_time = getTimeNow();
+  std::cout << "internWords: " << getMilliDuration(start_time, stop_time) << "ms ("
+    << ids.size() * sizeof(WordId) / 1024 << " KB of IDs, " << interner.memoryBytes() / 1024 << " KB interner)" << std::endl;
+
+  start_time = getTimeNow();
+  const StringIntPairVec sortedIds = sortWordIdCounts(countWordIds(ids, interner), interner);
+  stop_time = getTimeNow();
+  std::cout << "countWordIds + sortWordIdCounts: " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+
+  REQUIRE(sortedIds.size() == sortedStrings.size());
+
+}
+
+// ========================================================================
+// Tests: sortWordCounts
+// ========================================================================
+
+// Checks that sorted is in order of increasing count and has exactly the
+// records of wordcount_map.
+static bool isSortedCopyOf(const StringIntPairVec& sorted, const StringIntMap& wordcount_map) {
+  if (sorted.size() != wordcount_map.size()) return false;
+  StringIntMap seen;
+  for (std::size_t i = 0; i < sorted.size(); i++) {
+    if (i > 0 && wordCountComparator(sorted[i], sorted[i-1])) return false;
+    if (seen.count(sorted[i].first)) return false;
+    seen[sorted[i].first] = sorted[i].second;
+  }
+  return seen == wordcount_map;
+}
+
+TEST_CASE("Testing sortWordCounts", "[weight=0]") {
+
+  SECTION("Should sort the book's word counts") {
+    const StringIntMap wordcount_map = makeWordCounts(loadBookStrings(5));
+    const StringIntPairVec sorted = sortWordCounts(wordcount_map);
+    REQUIRE(isSortedCopyOf(sorted, wordcount_map));
+    REQUIRE(sorted.back() == StringIntPair("alice", 434));
+  }
+
+  SECTION("Should handle small maps") {
+    REQUIRE(sortWordCounts(StringIntMap()).empty());
+    REQUIRE(sortWordCounts(StringIntMap{{"dog", 3}}) == StringIntPairVec{{"dog", 3}});
+    REQUIRE(sortWordCounts(StringIntMap{{"dog", 3}, {"cat", 1}}) == StringIntPairVec({{"cat", 1}, {"dog", 3}}));
+  }
+
+  SECTION("Should sort counts over any range of ints") {
+    std::mt19937 rng(43);
+    // Small counts, huge counts, and negative counts.
+    for (int maxCount : {10, 100000, 2000000000}) {
+      StringIntMap wordcount_map;
+      std::uniform_int_distribution<int> countDistribution(-5, maxCount);
+      for (int i = 0; i < 3000; i++) {
+        wordcount_map["word" + std::to_string(i)] = countDistribution(rng);
+      }
+      wordcount_map["smallest"] = std::numeric_limits<int>::min();
+      wordcount_map["largest"] = std::numeric_limits<int>::max();
+      const StringIntPairVec sorted = sortWordCounts(wordcount_map);
+      REQUIRE(isSortedCopyOf(sorted, wordcount_map));
+      REQUIRE(sorted.front().first == "smallest");
+      REQUIRE(sorted.back().first == "largest");
+    }
+  }
+
+}
+
+// This is hidden because of the [.] tag.
+// You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: sortWordCounts vs. std::sort", "[weight=0][.][bench]") {
+
+  // Many unique words with roughly Zipf-distributed counts, like real text.
+  constexpr int UNIQUE_WORDS = 300000;
+  StringIntMap wordcount_map;
+  for (int i = 0; i < UNIQUE_WORDS; i++) {
+    wordcount_map["word" + std::to_string(i)] = 1 + 1000000 / (i + 1);
+  }
+
+  std::cout << std::endl << "Sorting " << UNIQUE_WORDS << " word counts:" << std::endl;
+
+  auto start_time = getTimeNow();
+  StringIntPairVec compared;
+  compared.reserve(wordcount_map.size());
+  for (const auto& wc : wordcount_map) {
+    compared.push_back(wc);
+  }
+  std::sort(compared.begin(), compared.end(), wordCountComparator);
+  auto stop_time = getTimeNow();
+  std::cout << "std::sort with wordCountComparator: " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+
+  start_time = getTimeNow();
+  const StringIntPairVec counted = sortWordCounts(wordcount_map);
+  stop_time = getTimeNow();
+  std::cout << "sortWordCounts (counting sort): " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+
+  REQUIRE(counted.size() == compared.size());
+
+}
+
+// ========================================================================
+// Tests: WordCountIndex
+// ========================================================================
+
+TEST_CASE("Testing WordCountIndex", "[weight=0]") {
+
+  const std::string filename = "week1_test_wordcounts.idx";
+  std::remove(filename.c_str());
+
+  SECTION("Should save and look up the book's word counts") {
+    const StringIntMap wordcount_map = makeWordCounts(loadBookStrings(5));
+    WordCountIndex::write(wordcount_map, filename);
+    {
+      const WordCountIndex index(filename);
+      REQUIRE(index.size() == wordcount_map.size());
+      REQUIRE(index.toMap() == wordcount_map);
+      REQUIRE(index.at("alice") == 434);
+      REQUIRE(lookupWithFallback(index, "alice", -1) == lookupWithFallback(wordcount_map, "alice", -1));
+      REQUIRE(lookupWithFallback(index, "zzzzz", -1) == -1);
+      REQUIRE(index.count("alice") == 1);
+      REQUIRE(index.count("alic") == 0);
+      REQUIRE_THROWS_AS(index.at("zzzzz"), std::out_of_range);
+      for (std::size_t i = 1; i < index.size(); i++) {
+        REQUIRE(index.word(i-1).str() < index.word(i).str());
+      }
+    }
+    std::remove(filename.c_str());
+  }
+
+  SECTION("Should merge new counts without recounting") {
+    WordCountIndex::merge(filename, StringIntMap{{"dog", 2}, {"cat", 1}});
+    WordCountIndex::merge(filename, StringIntMap{{"cat", 4}, {"bird", 1}, {"zebra", 3}, {"dog", -2}, {"emu", 0}});
+    {
+      const WordCountIndex index(filename);
+      REQUIRE(index.toMap() == StringIntMap({{"bird", 1}, {"cat", 5}, {"zebra", 3}}));
+      // An index that's open keeps its version of the file while another
+      // merge replaces it.
+      WordCountIndex::merge(filename, StringIntMap{{"aardvark", 7}});
+      REQUIRE(index.size() == 3);
+      REQUIRE(WordCountIndex(filename).at("aardvark") == 7);
+    }
+    WordCountIndex::merge(filename, StringIntMap());
+    REQUIRE(WordCountIndex(filename).size() == 4);
+    std::remove(filename.c_str());
+  }
+
+  SECTION("Should not disturb an open index when writing over it") {
+    const StringIntMap wordcount_map = makeWordCounts(loadBookStrings(5));
+    WordCountIndex::write(wordcount_map, filename);
+    {
+      const WordCountIndex index(filename);
+      WordCountIndex::write(StringIntMap{{"dog", 2}}, filename);
+      REQUIRE(index.toMap() == wordcount_map);
+      REQUIRE(WordCountIndex(filename).toMap() == StringIntMap({{"dog", 2}}));
+    }
+    std::remove(filename.c_str());
+  }
+
+  SECTION("Should match counting everything at once") {
+    const StringVec bookstrings = loadBookStrings(5);
+    const std::size_t half = bookstrings.size() / 2;
+    WordCountIndex::write(makeWordCounts(StringVec(bookstrings.begin(), bookstrings.begin() + half)), filename);
+    WordCountIndex::merge(filename, makeWordCounts(StringVec(bookstrings.begin() + half, bookstrings.end())));
+    REQUIRE(WordCountIndex(filename).toMap() == makeWordCounts(bookstrings));
+    std::remove(filename.c_str());
+  }
+
+  SECTION("Should reject files that aren't valid indexes") {
+    REQUIRE_THROWS_AS(WordCountIndex(filename), std::runtime_error);
+    WordCountIndex::write(StringIntMap{{"dog", 2}}, filename);
+    std::string contents;
+    {
+      std::ifstream file(filename, std::ios::binary);
+      contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    {
+      std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+      file.write(contents.data(), contents.size() - 1);
+    }
+    REQUIRE_THROWS_AS(WordCountIndex(filename), std::runtime_error);
+    {
+      contents[0] = 'X';
+      std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+      file.write(contents.data(), contents.size());
+    }
+    REQUIRE_THROWS_AS(WordCountIndex(filename), std::runtime_error);
+    std::remove(filename.c_str());
+  }
+
+}
+
+// This is hidden because of the [.] tag.
+// You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: recounting vs. WordCountIndex", "[weight=0][.][bench]") {
+
+  const std::string filename = "week1_bench_wordcounts.idx";
+  const StringVec bookstrings = loadBookStrings(5);
+  WordCountIndex::write(makeWordCounts(bookstrings), filename);
+
+  std::cout << std::endl << "Getting the count for \"alice\":" << std::endl;
+
+  auto start_time = getTimeNow();
+  const int recounted = lookupWithFallback(makeWordCounts(loadBookStrings(5)), "alice", 0);
+  auto stop_time = getTimeNow();
+  std::cout << "loadBookStrings + makeWordCounts: " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+
+  start_time = getTimeNow();
+  const int indexed = lookupWithFallback(WordCountIndex(filename), "alice", 0);
+  stop_time = getTimeNow();
+  std::cout << "WordCountIndex: " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+
+  start_time = getTimeNow();
+  WordCountIndex::merge(filename, makeWordCounts(StringVec(bookstrings.begin(), bookstrings.begin() + 1000)));
+  stop_time = getTimeNow();
+  std::cout << "Merging counts for 1000 new words: " << getMilliDuration(start_time, stop_time) << "ms" << std::endl;
+
+  std::remove(filename.c_str());
+  REQUIRE(recounted == indexed);
+
+}
+
+// ========================================================================
+// Tests: Instrumentation
+// ========================================================================
+
+TEST_CASE("Testing Instrumentation", "[weight=0]") {
+
+  SECTION("TimingHistogram should summarize durations") {
+    TimingHistogram histogram;
+    REQUIRE(histogram.count() == 0);
+    REQUIRE(histogram.meanNanoseconds() == 0.0);
+    for (std::uint64_t nanoseconds : {0, 1, 1000, 1500, 3000}) {
+      histogram.record(nanoseconds);
+    }
+    REQUIRE(histogram.count() == 5);
+    REQUIRE(histogram.totalNanoseconds() == 5501);
+    REQUIRE(histogram.minNanoseconds() == 0);
+    REQUIRE(histogram.maxNanoseconds() == 3000);
+    // 1000 and 1500 are both from 2^9 up to 2^10.
+    REQUIRE(TimingHistogram::bucketOf(1000) == 9);
+    REQUIRE(histogram.bucketCount(9) == 1);
+    REQUIRE(histogram.bucketCount(10) == 1);
+    REQUIRE(histogram.percentileNanoseconds(0.5) == 1023);
+    REQUIRE(histogram.percentileNanoseconds(1.0) == 3000);
+  }
+
+  SECTION("ScopedTimer should record into a registry") {
+    TimingRegistry registry;
+    for (int i = 0; i < 3; i++) {
+      ScopedTimer timer("sleepy", registry);
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    const TimingHistogram histogram = registry.histogram("sleepy");
+    REQUIRE(histogram.count() == 3);
+    REQUIRE(histogram.minNanoseconds() >= 2000000);
+    REQUIRE(registry.histogram("other").count() == 0);
+
+    std::ostringstream report;
+    registry.report(report);
+    REQUIRE(report.str().find("sleepy") != std::string::npos);
+    registry.clear();
+    REQUIRE(registry.histogram("sleepy").count() == 0);
+  }
+
+  SECTION("TimingSite should count recordings from many threads") {
+    TimingRegistry registry;
+    TimingSite& site = registry.site("shared");
+    REQUIRE(&registry.site("shared") == &site);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+      threads.emplace_back([&site, t] {
+        for (int i = 0; i < 1000; i++) {
+          site.record(1000 * (t + 1));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    {
+      ScopedTimer timer(site);
+    }
+    const TimingHistogram histogram = registry.histogram("shared");
+    REQUIRE(histogram.count() == 4001);
+    REQUIRE(histogram.totalNanoseconds() >= 10000000);
+    REQUIRE(histogram.maxNanoseconds() >= 4000);
+    // Only the first thread's durations are from 2^9 up to 2^10.
+    REQUIRE(histogram.bucketCount(TimingHistogram::bucketOf(1000)) == 1000);
+
+    // Clearing keeps the site, so references to it stay usable.
+    registry.clear();
+    REQUIRE(registry.histogram("shared").count() == 0);
+    site.record(5);
+    REQUIRE(registry.histogram("shared").minNanoseconds() == 5);
+  }
+
+  SECTION("DeadlineChecker should only read the clock every so often") {
+    // The limit has already passed, but the clock is only read on the
+    // tenth call.
+    DeadlineChecker checker(getTimeNow(), -1.0, 10);
+    REQUIRE(checker.expired());
+    for (int i = 0; i < 9; i++) {
+      checker.check();
+    }
+    REQUIRE_THROWS_AS(checker.check(), TooSlowException);
+
+    DeadlineChecker patient(getTimeNow(), 10000.0, 1);
+    for (int i = 0; i < 100; i++) {
+      patient.check();
+    }
+    REQUIRE(!patient.expired());
+  }
+
+}
@@ -9,7 +9,7 @@ ZIP_FILE = UnorderedMap_submission.zip
 COLLECTED_FILES = UnorderedMapExercises.cpp
 
 # Add standard object files (HSLAPixel, PNG, and LodePNG)
-OBJS += UnorderedMapCommon.o UnorderedMapExercises.o
+OBJS += UnorderedMapCommon.o UnorderedMapExercises.o ParallelWordCount.o MappedBook.o FlatStringIntMap.o TopWordCounts.o StreamingWordCounter.o PalindromeSolvers.o WavefrontPalindrome.o StringInterner.o WordCountIndex.o
 
 # Use ./.objs to store all .o file (keeping the directory clean)
 OBJS_DIR = .objs
@@ -0,0 +1,56 @@
+/**
+ * @file BidirectionalBFS.cpp
+ * University of Illinois CS 400, MOOC 3, Week 3: Graph Search
+ *
+ * Breadth-first search from both ends of the path at once.
+ *
+**/
+
+#include <iostream> // for std::cout
+#include <stdexcept> // for std::runtime_error
+
+#include "GraphSearchCommon.h"
+
+// Print the same warnings as graphBFS and puzzleBFS when there's no path.
+static void warnNoPath(const char* functionName, const BidirectionalBFSStats& stats) {
+  if (stats.tooManySteps) {
+    std::cout << functionName << " warning: Could not reach goal within the maximum allowed steps.\n (This may be expected if no path exists.)" << std::endl << std::endl;
+  }
+  else {
+    std::cout << functionName << " warning: Could not reach goal. (This may be expected\n if no path exists.)" << std::endl << std::endl;
+  }
+}
+
+std::list<IntPair> graphBidirectionalBFS(const IntPair& start, const IntPair& goal, const GridGraph& graph, BidirectionalBFSStats* stats) {
+  if (!graph.hasPoint(start)) throw std::runtime_error("Starting point doesn't exist in graph");
+  if (!graph.hasPoint(goal)) throw std::runtime_error("Goal point doesn't exist in graph");
+
+  // The same limit as graphBFS.
+  constexpr int maxDist = 100;
+
+  BidirectionalBFSStats localStats;
+  if (!stats) stats = &localStats;
+  auto getNeighbors = [&graph](const IntPair& p) -> const GridGraph::NeighborSet& {
+    return graph.adjacencyMap.at(p);
+  };
+  std::list<IntPair> path = bidirectionalBFS(start, goal, getNeighbors, maxDist, stats);
+  if (path.empty()) warnNoPath("graphBidirectionalBFS", *stats);
+  return path;
+}
+
+std::list<PuzzleState> puzzleBidirectionalBFS(const PuzzleState& start, const PuzzleState& goal, BidirectionalBFSStats* stats) {
+  // The same limit as puzzleBFS: no solvable 8 puzzle needs more than 35
+  // moves. With two searches, we stop once they are each about half that
+  // deep, instead of exploring every reachable state like puzzleBFS does
+  // for a puzzle that can't be solved.
+  constexpr int maxDist = 35;
+
+  BidirectionalBFSStats localStats;
+  if (!stats) stats = &localStats;
+  auto getNeighbors = [](const PuzzleState& state) {
+    return state.getAdjacentStates();
+  };
+  std::list<PuzzleState> path = bidirectionalBFS(start, goal, getNeighbors, maxDist, stats);
+  if (path.empty()) warnNoPath("puzzleBidirectionalBFS", *stats);
+  return path;
+}
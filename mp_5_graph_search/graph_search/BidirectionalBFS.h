@@ -0,0 +1,138 @@
+/**
+ * @file BidirectionalBFS.h
+ * University of Illinois CS 400, MOOC 3, Week 3: Graph Search
+ *
+ * Breadth-first search from both ends of the path at once.
+ *
+**/
+
+#pragma once
+
+#include <cstddef> // for std::size_t
+#include <list> // for std::list
+#include <unordered_map> // for std::unordered_map
+#include <vector> // for std::vector
+
+// Ordinary BFS searches outward from the start until it reaches the goal.
+// If the shortest path has d steps and each vertex has about b neighbors,
+// it visits roughly b^d vertices. Bidirectional BFS runs two searches at the
+// same time, one from the start and one from the goal, and stops as soon as
+// they meet in the middle. Each one only has to go about d/2 steps, so
+// together they visit roughly 2 * b^(d/2) vertices: about the square root
+// of the number that ordinary BFS needs.
+//
+// This works for any graph whose edges go both ways (undirected graphs),
+// since the search from the goal follows the edges backwards. GridGraph and
+// the PuzzleState graph model are both undirected.
+//
+// Each step expands one whole level of one of the searches (every vertex
+// at the same distance from its end), always choosing the search with the
+// smaller frontier, since that's the cheaper one to grow. When vertices
+// from the two searches meet, we finish the level and keep the meeting with
+// the shortest total path, which is then a shortest path overall.
+
+// Extra information about a search, for testing and measuring.
+struct BidirectionalBFSStats {
+  // The number of vertices discovered by both searches together.
+  std::size_t visitedCount = 0;
+  // Whether the search gave up because the path would be longer than maxDist.
+  bool tooManySteps = false;
+};
+
+// The state of the search from one end.
+template <typename Vertex>
+struct BidirectionalBFSSide {
+  std::unordered_map<Vertex, Vertex> pred;
+  std::unordered_map<Vertex, int> dist;
+  // The vertices that are depth steps away, to be explored next.
+  std::vector<Vertex> frontier;
+  int depth = 0;
+
+  explicit BidirectionalBFSSide(const Vertex& origin) {
+    pred.emplace(origin, origin);
+    dist.emplace(origin, 0);
+    frontier.push_back(origin);
+  }
+};
+
+// Find a shortest path from start to goal with at most maxDist steps, and
+// return it as a list from start to goal, or return an empty list if there
+// is none. getNeighbors(v) must return a collection of the vertices adjacent
+// to v, and Vertex must have std::hash support, like for graphBFS.
+template <typename Vertex, typename GetNeighbors>
+std::list<Vertex> bidirectionalBFS(const Vertex& start, const Vertex& goal, GetNeighbors getNeighbors, int maxDist,
+  BidirectionalBFSStats* stats=nullptr) {
+
+  BidirectionalBFSStats localStats;
+  if (!stats) stats = &localStats;
+  *stats = BidirectionalBFSStats();
+
+  if (start == goal) {
+    stats->visitedCount = 1;
+    return std::list<Vertex>{start};
+  }
+
+  BidirectionalBFSSide<Vertex> fromStart(start);
+  BidirectionalBFSSide<Vertex> fromGoal(goal);
+
+  // The vertex where the searches met on the shortest path found so far.
+  Vertex meeting = start;
+  bool met = false;
+
+  while (!met) {
+    // If either search has run out of vertices, it has found everything
+    // connected to its end without meeting the other, so there is no path.
+    if (fromStart.frontier.empty() || fromGoal.frontier.empty()) break;
+
+    // Any path we haven't found yet must be longer than the two depths put
+    // together, or the searches would already have met.
+    if (fromStart.depth + fromGoal.depth >= maxDist) {
+      stats->tooManySteps = true;
+      break;
+    }
+
+    const bool expandStart = fromStart.frontier.size() <= fromGoal.frontier.size();
+    BidirectionalBFSSide<Vertex>& side = expandStart ? fromStart : fromGoal;
+    const BidirectionalBFSSide<Vertex>& other = expandStart ? fromGoal : fromStart;
+
+    int bestLength = 0;
+    std::vector<Vertex> nextFrontier;
+    for (const Vertex& cur : side.frontier) {
+      for (const Vertex& neighbor : getNeighbors(cur)) {
+        if (side.pred.count(neighbor)) continue;
+        side.pred.emplace(neighbor, cur);
+        side.dist.emplace(neighbor, side.depth + 1);
+        nextFrontier.push_back(neighbor);
+
+        auto otherDist = other.dist.find(neighbor);
+        if (otherDist != other.dist.end()) {
+          const int length = side.depth + 1 + otherDist->second;
+          if (!met || length < bestLength) {
+            met = true;
+            bestLength = length;
+            meeting = neighbor;
+          }
+        }
+      }
+    }
+    side.frontier.swap(nextFrontier);
+    side.depth++;
+  }
+
+  stats->visitedCount = fromStart.pred.size() + fromGoal.pred.size();
+  if (!met) {
+    return std::list<Vertex>();
+  }
+
+  // Walk from the meeting point back to the start, then forward to the goal.
+  std::list<Vertex> path;
+  for (Vertex cur = meeting; ; cur = fromStart.pred.at(cur)) {
+    path.push_front(cur);
+    if (cur == start) break;
+  }
+  for (Vertex cur = meeting; cur != goal; ) {
+    cur = fromGoal.pred.at(cur);
+    path.push_back(cur);
+  }
+  return path;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file DenseGridGraph.cpp
+ * University of Illinois CS 400, MOOC 3, Week 3: Graph Search
+ *
+ * A GridGraph stored as one byte per grid cell.
+ *
+**/
+
+#include <algorithm> // for std::min, std::max
+#include <iostream> // for std::cerr
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::runtime_error, std::length_error
+#include <utility> // for std::pair
+
+#include "DenseGridGraph.h"
+
+// In some versions of C++ we have to redeclare constant static members
+// at global scope like this to ensure that the linker doesn't give an error.
+constexpr std::uint8_t DenseGridGraph::UP;
+constexpr std::uint8_t DenseGridGraph::DOWN;
+constexpr std::uint8_t DenseGridGraph::LEFT;
+constexpr std::uint8_t DenseGridGraph::RIGHT;
+constexpr std::uint8_t DenseGridGraph::EDGE_MASK;
+constexpr std::uint8_t DenseGridGraph::POINT;
+constexpr std::uint8_t DenseGridGraph::DIRECTIONS[4];
+
+DenseGridGraph::DenseGridGraph(const IntPair& minPoint, const IntPair& maxPoint)
+  : minRow_(minPoint.first), minCol_(minPoint.second), rowCount_(0), colCount_(0), pointCount_(0), edgeCount_(0) {
+
+  if (maxPoint.first < minPoint.first || maxPoint.second < minPoint.second) {
+    throw std::runtime_error("DenseGridGraph: the bounding box's max point is below its min point");
+  }
+  const long long rowCount = static_cast<long long>(maxPoint.first) - minPoint.first + 1;
+  const long long colCount = static_cast<long long>(maxPoint.second) - minPoint.second + 1;
+  // Vertex IDs are ints, so the number of cells must fit in an int.
+  if (rowCount * colCount > std::numeric_limits<int>::max()) {
+    throw std::length_error("DenseGridGraph: the bounding box has too many cells");
+  }
+  rowCount_ = static_cast<int>(rowCount);
+  colCount_ = static_cast<int>(colCount);
+  cells_.assign(static_cast<std::size_t>(rowCount * colCount), 0);
+}
+
+// Find the bounding box of a GridGraph's points. (An empty graph gets a
+// box with a single cell.)
+static std::pair<IntPair, IntPair> boundingBoxOf(const GridGraph& graph) {
+  if (graph.adjacencyMap.empty()) {
+    return std::make_pair(IntPair(0,0), IntPair(0,0));
+  }
+  IntPair minPoint = graph.adjacencyMap.begin()->first;
+  IntPair maxPoint = minPoint;
+  for (const auto& kv : graph.adjacencyMap) {
+    minPoint.first = std::min(minPoint.first, kv.first.first);
+    minPoint.second = std::min(minPoint.second, kv.first.second);
+    maxPoint.first = std::max(maxPoint.first, kv.first.first);
+    maxPoint.second = std::max(maxPoint.second, kv.first.second);
+  }
+  return std::make_pair(minPoint, maxPoint);
+}
+
+DenseGridGraph::DenseGridGraph(const GridGraph& graph)
+  : DenseGridGraph(boundingBoxOf(graph).first, boundingBoxOf(graph).second) {
+
+  for (const auto& kv : graph.adjacencyMap) {
+    insertPoint(kv.first);
+    for (const IntPair& neighbor : kv.second) {
+      insertEdge(kv.first, neighbor);
+    }
+  }
+}
+
+bool DenseGridGraph::checkUnitDistance(const IntPair& p1, const IntPair& p2) const {
+  const long long dist_x = static_cast<long long>(p1.first) - p2.first;
+  const long long dist_y = static_cast<long long>(p1.second) - p2.second;
+  return (dist_x*dist_x + dist_y*dist_y == 1);
+}
+
+std::uint8_t DenseGridGraph::directionOf(const IntPair& p1, const IntPair& p2) {
+  if (p2.first < p1.first) return UP;
+  if (p2.first > p1.first) return DOWN;
+  if (p2.second < p1.second) return LEFT;
+  return RIGHT;
+}
+
+std::uint8_t DenseGridGraph::oppositeOf(std::uint8_t direction) {
+  return (UP == direction) ? DOWN : (DOWN == direction) ? UP : (LEFT == direction) ? RIGHT : LEFT;
+}
+
+void DenseGridGraph::checkInBounds(const IntPair& p) const {
+  if (!inBounds(p)) {
+    std::cerr << "Error: " << p << " is outside the DenseGridGraph bounding box from "
+      << getMinPoint() << " to " << getMaxPoint() << std::endl;
+    throw std::runtime_error("DenseGridGraph: point outside the bounding box");
+  }
+}
+
+void DenseGridGraph::insertPoint(const IntPair& p) {
+  checkInBounds(p);
+  std::uint8_t& cell = cells_[idOf(p)];
+  if (!(cell & POINT)) {
+    cell |= POINT;
+    pointCount_++;
+  }
+}
+
+void DenseGridGraph::insertEdge(const IntPair& p1, const IntPair& p2) {
+  if (!checkUnitDistance(p1, p2)) {
+    std::cerr << "Error: Can't add edge from " << p1 << " to " << p2 << std::endl;
+    std::cerr << "Points must be 1 unit apart." << std::endl;
+    throw std::runtime_error("Requested an invalid edge insertion");
+  }
+  checkInBounds(p1);
+  checkInBounds(p2);
+
+  insertPoint(p1);
+  insertPoint(p2);
+  const std::uint8_t direction = directionOf(p1, p2);
+  std::uint8_t& cell1 = cells_[idOf(p1)];
+  if (!(cell1 & direction)) {
+    cell1 |= direction;
+    cells_[idOf(p2)] |= oppositeOf(direction);
+    edgeCount_++;
+  }
+}
+
+bool DenseGridGraph::hasEdge(const IntPair& p1, const IntPair& p2) const {
+  // Both ends of an edge are always updated together, so unlike GridGraph
+  // we only need to look at one of them.
+  return checkUnitDistance(p1, p2) && inBounds(p1) && inBounds(p2) && (cells_[idOf(p1)] & directionOf(p1, p2));
+}
+
+void DenseGridGraph::removeEdge(const IntPair& p1, const IntPair& p2) {
+  if (hasEdge(p1, p2)) {
+    const std::uint8_t direction = directionOf(p1, p2);
+    cells_[idOf(p1)] &= ~direction;
+    cells_[idOf(p2)] &= ~oppositeOf(direction);
+    edgeCount_--;
+  }
+}
+
+void DenseGridGraph::removePoint(const IntPair& p) {
+  if (!hasPoint(p)) return;
+  const int id = idOf(p);
+  for (std::uint8_t direction : DIRECTIONS) {
+    if (cells_[id] & direction) {
+      cells_[id + idOffset(direction)] &= ~oppositeOf(direction);
+      edgeCount_--;
+    }
+  }
+  cells_[id] = 0;
+  pointCount_--;
+}
+
+std::vector<IntPair> DenseGridGraph::getNeighbors(const IntPair& p) const {
+  std::vector<IntPair> neighbors;
+  if (!hasPoint(p)) return neighbors;
+  const int id = idOf(p);
+  for (std::uint8_t direction : DIRECTIONS) {
+    if (cells_[id] & direction) {
+      neighbors.push_back(pointOf(id + idOffset(direction)));
+    }
+  }
+  return neighbors;
+}
+
+GridGraph DenseGridGraph::toGridGraph() const {
+  GridGraph graph;
+  for (int id = 0; id < cellCount(); id++) {
+    if (!(cells_[id] & POINT)) continue;
+    const IntPair p = pointOf(id);
+    graph.insertPoint(p);
+    // Insert each edge from its upper or left end only.
+    if (cells_[id] & DOWN) graph.insertEdge(p, pointOf(id + colCount_));
+    if (cells_[id] & RIGHT) graph.insertEdge(p, pointOf(id + 1));
+  }
+  return graph;
+}
+
+bool DenseGridGraph::operator==(const DenseGridGraph& other) const {
+  if (pointCount_ != other.pointCount_ || edgeCount_ != other.edgeCount_) return false;
+  // With equal counts, it's enough that every point of ours is in the
+  // other graph with the same edges.
+  for (int id = 0; id < cellCount(); id++) {
+    if (!(cells_[id] & POINT)) continue;
+    const IntPair p = pointOf(id);
+    if (!other.hasPoint(p) || (other.cells_[other.idOf(p)] != cells_[id])) return false;
+  }
+  return true;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file DenseGridGraph.h
+ * University of Illinois CS 400, MOOC 3, Week 3: Graph Search
+ *
+ * A GridGraph stored as one byte per grid cell.
+ *
+**/
+
+#pragma once
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t
+#include <ostream> // for std::ostream
+#include <vector> // for std::vector
+
+#include "IntPair2.h" // for IntPair
+#include "GridGraph.h"
+
+// GridGraph keeps an unordered_map from each point to an unordered_set of
+// its neighbors. That's very flexible, but every point costs a hash table
+// node plus a whole hash table of its own, just to remember at most four
+// neighbors, and every lookup has to hash the point first.
+//
+// When the points all lie inside a known rectangle (the "bounding box"),
+// we can do much better: give every cell of the rectangle one byte, and use
+// four bits of that byte to record which of its four possible neighbors it
+// has an edge to, plus one more bit to record whether the point is in the
+// graph at all. Finding a point is then just arithmetic on its coordinates.
+//
+// Each cell also has a "vertex ID", its position in the rectangle read row
+// by row, so searches can keep their own records in plain arrays indexed by
+// ID instead of in hash maps.
+class DenseGridGraph {
+public:
+
+  // The bits of a cell. An edge from a point to its neighbor above (one row
+  // lower) is recorded in the point's UP bit, and also in the neighbor's
+  // DOWN bit.
+  static constexpr std::uint8_t UP = 1;
+  static constexpr std::uint8_t DOWN = 2;
+  static constexpr std::uint8_t LEFT = 4;
+  static constexpr std::uint8_t RIGHT = 8;
+  static constexpr std::uint8_t EDGE_MASK = UP | DOWN | LEFT | RIGHT;
+  static constexpr std::uint8_t POINT = 16;
+
+  // The four directions, for looping over a cell's edge bits.
+  static constexpr std::uint8_t DIRECTIONS[4] = {UP, DOWN, LEFT, RIGHT};
+
+  // Make an empty graph that can hold points from minPoint to maxPoint,
+  // inclusive, in both coordinates.
+  DenseGridGraph(const IntPair& minPoint, const IntPair& maxPoint);
+
+  // Copy a GridGraph, using the smallest bounding box that holds all its points.
+  explicit DenseGridGraph(const GridGraph& graph);
+
+  IntPair getMinPoint() const { return IntPair(minRow_, minCol_); }
+  IntPair getMaxPoint() const { return IntPair(minRow_ + rowCount_ - 1, minCol_ + colCount_ - 1); }
+  int getRowCount() const { return rowCount_; }
+  int getColCount() const { return colCount_; }
+
+  // The number of cells in the bounding box, which is also one more than
+  // the largest vertex ID.
+  int cellCount() const { return static_cast<int>(cells_.size()); }
+
+  // Whether a point is inside the bounding box (whether or not it's in the graph).
+  bool inBounds(const IntPair& p) const {
+    // Subtract in long long: p.first - minRow_ can overflow int when minRow_ is negative.
+    return p.first >= minRow_ && static_cast<long long>(p.first) - minRow_ < rowCount_ &&
+           p.second >= minCol_ && static_cast<long long>(p.second) - minCol_ < colCount_;
+  }
+
+  // Convert between points and vertex IDs. The point must be in bounds.
+  int idOf(const IntPair& p) const { return (p.first - minRow_) * colCount_ + (p.second - minCol_); }
+  IntPair pointOf(int id) const { return IntPair(minRow_ + id / colCount_, minCol_ + id % colCount_); }
+
+  // The cell byte for a vertex ID: POINT if the point is in the graph, and
+  // the direction bits of its edges.
+  std::uint8_t cellAt(int id) const { return cells_[id]; }
+
+  // How much the vertex ID changes when moving in one direction.
+  int idOffset(std::uint8_t direction) const {
+    return (UP == direction) ? -colCount_ : (DOWN == direction) ? colCount_ : (LEFT == direction) ? -1 : 1;
+  }
+
+  // The same operations as GridGraph. Points outside the bounding box are
+  // never in the graph, and trying to insert one throws std::runtime_error.
+  bool checkUnitDistance(const IntPair& p1, const IntPair& p2) const;
+  void insertPoint(const IntPair& p);
+  void insertEdge(const IntPair& p1, const IntPair& p2);
+  void removeEdge(const IntPair& p1, const IntPair& p2);
+  void removePoint(const IntPair& p);
+  bool hasPoint(const IntPair& p) const { return inBounds(p) && (cells_[idOf(p)] & POINT); }
+  bool hasEdge(const IntPair& p1, const IntPair& p2) const;
+
+  // These are kept up to date as the graph changes, so they take no time.
+  int countVertices() const { return pointCount_; }
+  int countEdges() const { return edgeCount_; }
+
+  // The adjacent points of a point in the graph.
+  std::vector<IntPair> getNeighbors(const IntPair& p) const;
+
+  // The same graph as a GridGraph, for printing or comparing.
+  GridGraph toGridGraph() const;
+
+  // Two graphs are equal if they have the same points and edges, even if
+  // their bounding boxes are different.
+  bool operator==(const DenseGridGraph& other) const;
+  bool operator!=(const DenseGridGraph& other) const { return !(*this == other); }
+
+  // The memory used by the cells.
+  std::size_t memoryBytes() const { return cells_.capacity() * sizeof(std::uint8_t); }
+
+private:
+  int minRow_;
+  int minCol_;
+  int rowCount_;
+  int colCount_;
+  int pointCount_;
+  int edgeCount_;
+  std::vector<std::uint8_t> cells_;
+
+  // The direction bit for the edge from p1 to p2, which must be 1 unit apart.
+  static std::uint8_t directionOf(const IntPair& p1, const IntPair& p2);
+  // The bit for the same edge seen from the other end.
+  static std::uint8_t oppositeOf(std::uint8_t direction);
+
+  void checkInBounds(const IntPair& p) const;
+};
+
+// Plot a DenseGridGraph the same way as a GridGraph.
+static inline std::ostream& operator<<(std::ostream& os, const DenseGridGraph& graph) {
+  return os << graph.toGridGraph();
+}
@@ -37,15 +37,52 @@
 // graph data structure using std::unordered_map.
 #include "GridGraph.h"
 
+// The same kind of graph stored as one byte per cell of a bounding box,
+// which is much smaller and faster when the points fill most of the box.
+#include "DenseGridGraph.h"
+
+// A breadth-first search engine for DenseGridGraph that keeps its memory
+// between searches, for answering many path queries on the same grid.
+#include "GridBFS.h"
+
+// Breadth-first search from the start and the goal at the same time.
+#include "BidirectionalBFS.h"
+
 // Each PuzzleState represents one current state of the "8 puzzle", a sliding
 // tile puzzle which is played on a 3x3 grid containing 8 square tiles (so the
 // 9th space is blank), where any tile adjacent to the blank space can slide
 // into the blank space.
 #include "PuzzleState.h"
 
+// A* and IDA* search for sliding tile puzzles, which use an estimate of the
+// distance to the goal to avoid exploring most of the states BFS would.
+#include "PuzzleSolvers.h"
+
+// PuzzleState packed into a single 64-bit integer, with a "rank" that numbers
+// all the possible states, so searches can use arrays instead of hash tables.
+#include "PackedPuzzleState.h"
+
 // This function is defined in GraphSearchExercises.cpp
 std::list<IntPair> graphBFS(const IntPair& start, const IntPair& goal, const GridGraph& graph);
 
 // This function is defined in GraphSearchExercises.cpp
 std::list<PuzzleState> puzzleBFS(const PuzzleState& start, const PuzzleState& goal);
 
+// These functions are defined in BidirectionalBFS.cpp. They return the same
+// shortest paths as graphBFS and puzzleBFS, but search from both ends at once.
+// If stats isn't null, it's filled in with information about the search.
+std::list<IntPair> graphBidirectionalBFS(const IntPair& start, const IntPair& goal, const GridGraph& graph,
+  BidirectionalBFSStats* stats=nullptr);
+std::list<PuzzleState> puzzleBidirectionalBFS(const PuzzleState& start, const PuzzleState& goal,
+  BidirectionalBFSStats* stats=nullptr);
+
+// These functions are defined in PuzzleSolvers.cpp. They return a shortest
+// solution like puzzleBFS, using A* or IDA* search. If the puzzle can't be
+// solved, they return an empty list right away. If stats isn't null, it's
+// filled in with information about the search.
+std::list<PuzzleState> puzzleAStar(const PuzzleState& start, const PuzzleState& goal, PuzzleSearchStats* stats=nullptr);
+std::list<PuzzleState> puzzleIDAStar(const PuzzleState& start, const PuzzleState& goal, PuzzleSearchStats* stats=nullptr);
+
+// This function is defined in PackedPuzzleState.cpp. It's the same search as
+// puzzleBFS, with PackedPuzzleState and arrays indexed by rank.
+std::list<PuzzleState> puzzleRankBFS(const PuzzleState& start, const PuzzleState& goal);
@@ -52,7 +52,7 @@ int GridGraph::countEdges() const {
   // =======================================================================
   // TODO: Your code here!
   // =======================================================================
-  for(const std::pair<IntPair, GridGraph::NeighborSet>& pair : adjacencyMap) {
+  for(const auto& pair : adjacencyMap) {
     numEdges += pair.second.size();
   }
   return numEdges / 2;
@@ -0,0 +1,140 @@
+/**
+ * @file GridBFS.cpp
+ * University of Illinois CS 400, MOOC 3, Week 3: Graph Search
+ *
+ * Breadth-first search on a DenseGridGraph that reuses its memory.
+ *
+**/
+
+#include <algorithm> // for std::reverse, std::fill
+#include <iostream> // for std::cout
+#include <stdexcept> // for std::runtime_error
+
+#include "GridBFS.h"
+
+// The queue's starting size. It must be a power of two.
+static constexpr std::size_t INITIAL_QUEUE_SIZE = 1024;
+
+GridBFS::GridBFS()
+  : epoch_(0), queue_(INITIAL_QUEUE_SIZE), queueHead_(0), queueTail_(0), visitedCount_(0) {}
+
+void GridBFS::beginSearch(int cellCount) {
+  if (stamp_.size() < static_cast<std::size_t>(cellCount)) {
+    // New cells get stamp 0, which is never a current epoch.
+    stamp_.resize(cellCount, 0);
+    pred_.resize(cellCount);
+  }
+  epoch_++;
+  if (0 == epoch_) {
+    // After four billion searches the epoch wraps around to 0, and old
+    // stamps could look current again, so clear them and start over.
+    std::fill(stamp_.begin(), stamp_.end(), 0);
+    epoch_ = 1;
+  }
+  queueHead_ = 0;
+  queueTail_ = 0;
+  visitedCount_ = 0;
+}
+
+void GridBFS::push(int id) {
+  if (queueTail_ - queueHead_ == queue_.size()) {
+    // The ring is full. Double it, moving the entries so that they start
+    // at the beginning and keep their order.
+    std::vector<int> bigger(queue_.size() * 2);
+    for (std::size_t i = queueHead_; i < queueTail_; i++) {
+      bigger[i - queueHead_] = queue_[i & (queue_.size() - 1)];
+    }
+    queueTail_ -= queueHead_;
+    queueHead_ = 0;
+    queue_.swap(bigger);
+  }
+  queue_[queueTail_++ & (queue_.size() - 1)] = id;
+}
+
+// The same algorithm as graphBFS (see the comments in GraphSearchExercises.cpp),
+// except that instead of recording every vertex's distance, we count how far
+// we are by going through the queue one distance at a time: levelEnd marks
+// where the vertices at the current distance end.
+GridBFS::Result GridBFS::search(const DenseGridGraph& graph, int startId, int goalId, int maxDist) {
+  beginSearch(graph.cellCount());
+  visit(startId, startId);
+  if (startId == goalId) return Result::FOUND;
+  push(startId);
+
+  int curDist = 0;
+  std::size_t levelEnd = queueTail_;
+  while (queueHead_ != queueTail_) {
+    if (queueHead_ == levelEnd) {
+      curDist++;
+      levelEnd = queueTail_;
+    }
+    const int curId = pop();
+    const std::uint8_t cell = graph.cellAt(curId);
+    for (std::uint8_t direction : DenseGridGraph::DIRECTIONS) {
+      if (!(cell & direction)) continue;
+      const int neighborId = curId + graph.idOffset(direction);
+      if (isVisited(neighborId)) continue;
+      visit(neighborId, curId);
+      if (curDist + 1 > maxDist) return Result::TOO_MANY_STEPS;
+      if (neighborId == goalId) return Result::FOUND;
+      push(neighborId);
+    }
+  }
+  return Result::UNREACHABLE;
+}
+
+GridBFS::Result GridBFS::findPathIds(const DenseGridGraph& graph, int startId, int goalId, std::vector<int>& pathIds, int maxDist) {
+  pathIds.clear();
+  if (startId < 0 || startId >= graph.cellCount() || !(graph.cellAt(startId) & DenseGridGraph::POINT)) {
+    throw std::runtime_error("Starting point doesn't exist in graph");
+  }
+  if (goalId < 0 || goalId >= graph.cellCount() || !(graph.cellAt(goalId) & DenseGridGraph::POINT)) {
+    throw std::runtime_error("Goal point doesn't exist in graph");
+  }
+
+  const Result result = search(graph, startId, goalId, maxDist);
+  if (Result::FOUND == result) {
+    // Walk back from the goal, then put the path in order.
+    for (int cur = goalId; ; cur = pred_[cur]) {
+      pathIds.push_back(cur);
+      if (pred_[cur] == cur) break;
+    }
+    std::reverse(pathIds.begin(), pathIds.end());
+  }
+  return result;
+}
+
+GridBFS::Result GridBFS::findPath(const DenseGridGraph& graph, const IntPair& start, const IntPair& goal, std::vector<IntPair>& path, int maxDist) {
+  path.clear();
+  if (!graph.hasPoint(start)) throw std::runtime_error("Starting point doesn't exist in graph");
+  if (!graph.hasPoint(goal)) throw std::runtime_error("Goal point doesn't exist in graph");
+
+  const int goalId = graph.idOf(goal);
+  const Result result = search(graph, graph.idOf(start), goalId, maxDist);
+  if (Result::FOUND == result) {
+    for (int cur = goalId; ; cur = pred_[cur]) {
+      path.push_back(graph.pointOf(cur));
+      if (pred_[cur] == cur) break;
+    }
+    std::reverse(path.begin(), path.end());
+  }
+  return result;
+}
+
+// ========================================================================
+//   graphBFS for DenseGridGraph
+// ========================================================================
+
+std::list<IntPair> graphBFS(const IntPair& start, const IntPair& goal, const DenseGridGraph& graph, int maxDist) {
+  GridBFS bfs;
+  std::vector<IntPair> path;
+  const GridBFS::Result result = bfs.findPath(graph, start, goal, path, maxDist);
+
+  if (GridBFS::Result::TOO_MANY_STEPS == result) {
+    std::cout << "graphBFS warning: Could not reach goal within the maximum allowed steps.\n (This may be expected if no path exists.)" << std::endl << std::endl;
+  }
+  else if (GridBFS::Result::UNREACHABLE == result) {
+    std::cout << "graphBFS warning: Could not reach goal. (This may be expected\n if no path exists.)" << std::endl << std::endl;
+  }
+  return std::list<IntPair>(path.begin(), path.end());
+}
@@ -0,0 +1,98 @@
+/**
+ * @file GridBFS.h
+ * University of Illinois CS 400, MOOC 3, Week 3: Graph Search
+ *
+ * Breadth-first search on a DenseGridGraph that reuses its memory.
+ *
+**/
+
+#pragma once
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint32_t
+#include <limits> // for std::numeric_limits
+#include <list> // for std::list
+#include <vector> // for std::vector
+
+#include "IntPair2.h" // for IntPair
+#include "DenseGridGraph.h"
+
+// graphBFS builds new maps, sets and a queue for every search, and frees
+// them all again at the end. When we need to answer many path queries on
+// the same grid, that memory management can take longer than the search.
+//
+// A GridBFS object keeps its search records between searches instead, in
+// arrays indexed by DenseGridGraph vertex ID:
+//
+// - stamp_: the visited "set". Each search has its own number, the epoch,
+//   and a vertex has been visited in the current search if its stamp equals
+//   the current epoch. Starting a new search just adds one to the epoch, so
+//   there's nothing to clear.
+// - pred_: the predecessor of each visited vertex (only meaningful where
+//   the stamp is current).
+// - queue_: a ring buffer for the exploration queue. The queue only ever
+//   holds the current frontier of the search, which is usually much smaller
+//   than the graph, so it starts small and doubles when it fills up.
+//
+// The path is written into a vector that the caller provides and can reuse.
+// Once the arrays have grown to fit the graph (and the caller's vector to
+// fit the path), a search doesn't allocate any memory at all.
+class GridBFS {
+public:
+
+  enum class Result {
+    FOUND,
+    UNREACHABLE,
+    // The goal is further away than the maxDist we were given (or unreachable).
+    TOO_MANY_STEPS
+  };
+
+  GridBFS();
+
+  // Find a shortest path from start to goal, of at most maxDist steps. If
+  // one is found, path is set to the points along it, from start to goal;
+  // otherwise path is left empty. Throws std::runtime_error if start or
+  // goal isn't a point in the graph, like graphBFS.
+  Result findPath(const DenseGridGraph& graph, const IntPair& start, const IntPair& goal, std::vector<IntPair>& path,
+    int maxDist=std::numeric_limits<int>::max());
+
+  // The same, with vertex IDs instead of points.
+  Result findPathIds(const DenseGridGraph& graph, int startId, int goalId, std::vector<int>& pathIds,
+    int maxDist=std::numeric_limits<int>::max());
+
+  // The number of vertices the last search visited.
+  int getVisitedCount() const { return visitedCount_; }
+
+  // The memory held for reuse by the next search.
+  std::size_t memoryBytes() const {
+    return stamp_.capacity() * sizeof(std::uint32_t) + pred_.capacity() * sizeof(int) + queue_.capacity() * sizeof(int);
+  }
+
+private:
+  std::vector<std::uint32_t> stamp_;
+  std::uint32_t epoch_;
+  std::vector<int> pred_;
+  std::vector<int> queue_;
+  // The queue's front and back, counting every push and pop since the
+  // search began. The position in queue_ is the count modulo its size.
+  std::size_t queueHead_;
+  std::size_t queueTail_;
+  int visitedCount_;
+
+  // Run the search, leaving the predecessors in pred_.
+  Result search(const DenseGridGraph& graph, int startId, int goalId, int maxDist);
+
+  void beginSearch(int cellCount);
+  bool isVisited(int id) const { return stamp_[id] == epoch_; }
+  void visit(int id, int pred) {
+    stamp_[id] = epoch_;
+    pred_[id] = pred;
+    visitedCount_++;
+  }
+  void push(int id);
+  int pop() { return queue_[queueHead_++ & (queue_.size() - 1)]; }
+};
+
+// The same search as graphBFS for GridGraph, using a GridBFS. The path is at
+// most maxDist steps long. (Defined in GridBFS.cpp)
+std::list<IntPair> graphBFS(const IntPair& start, const IntPair& goal, const DenseGridGraph& graph, int maxDist=100);
@@ -0,0 +1,201 @@
+/**
+ * @file PackedPuzzleState.cpp
+ * University of Illinois CS 400, MOOC 3, Week 3: Graph Search
+ *
+ * An 8 puzzle state packed into 64 bits, with a perfect hash.
+ *
+**/
+
+#include <iostream> // for std::cout
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::runtime_error
+#include <vector> // for std::vector
+
+#include "GraphSearchCommon.h"
+
+// In some versions of C++ we have to redeclare constant static members
+// at global scope like this to ensure that the linker doesn't give an error.
+constexpr std::uint32_t PackedPuzzleState::RANK_COUNT;
+
+// FACTORIALS[i] is i!, the place value of the Lehmer code digit for the
+// tile with i tiles after it.
+static constexpr std::uint32_t FACTORIALS[9] = {1, 1, 2, 6, 24, 120, 720, 5040, 40320};
+
+PackedPuzzleState::PackedPuzzleState() : bits_(pack({1,2,3,4,5,6,7,8,9})) {}
+
+PackedPuzzleState::PackedPuzzleState(const std::array<int, 9>& data) : bits_(0) {
+  if (!PuzzleState::validateArray(data)) {
+    throw std::runtime_error("PackedPuzzleState: invalid data");
+  }
+  bits_ = pack(data);
+}
+
+std::uint64_t PackedPuzzleState::pack(const std::array<int, 9>& data) {
+  std::uint64_t bits = 0;
+  for (int i = 0; i < 9; i++) {
+    bits |= static_cast<std::uint64_t>(data[i] - 1) << (4*i);
+  }
+  return bits;
+}
+
+std::array<int, 9> PackedPuzzleState::getData() const {
+  std::array<int, 9> data;
+  for (int i = 0; i < 9; i++) {
+    data[i] = tileAt(i);
+  }
+  return data;
+}
+
+int PackedPuzzleState::getBlankIndex() const {
+  for (int i = 0; i < 9; i++) {
+    if (9 == tileAt(i)) return i;
+  }
+  throw std::runtime_error("getBlankIndex: not found; invalid puzzle state");
+}
+
+std::uint32_t PackedPuzzleState::rank() const {
+  // usedTiles has bit t set once tile t+1 has been seen. The number of
+  // smaller tiles still to the right of a tile is its value minus the
+  // number of smaller tiles already seen to its left.
+  std::uint32_t result = 0;
+  unsigned int usedTiles = 0;
+  for (int i = 0; i < 9; i++) {
+    const int tile = tileAt(i) - 1;
+    const int smallerSeen = __builtin_popcount(usedTiles & ((1u << tile) - 1));
+    result += (tile - smallerSeen) * FACTORIALS[8 - i];
+    usedTiles |= 1u << tile;
+  }
+  return result;
+}
+
+PackedPuzzleState PackedPuzzleState::unrank(std::uint32_t rank) {
+  if (rank >= RANK_COUNT) {
+    throw std::runtime_error("PackedPuzzleState::unrank: rank out of range");
+  }
+  // Read the rank's digits from the largest place value down. Each digit
+  // says which of the tiles not used yet comes next: 0 for the smallest,
+  // 1 for the next smallest, and so on.
+  std::uint64_t bits = 0;
+  unsigned int usedTiles = 0;
+  for (int i = 0; i < 9; i++) {
+    int digit = rank / FACTORIALS[8 - i];
+    rank %= FACTORIALS[8 - i];
+    int tile = 0;
+    while (true) {
+      if (!(usedTiles & (1u << tile))) {
+        if (0 == digit) break;
+        digit--;
+      }
+      tile++;
+    }
+    usedTiles |= 1u << tile;
+    bits |= static_cast<std::uint64_t>(tile) << (4*i);
+  }
+  return fromBits(bits);
+}
+
+PackedPuzzleState PackedPuzzleState::swapped(int index1, int index2) const {
+  // XOR each of the two tiles with the difference between them, which
+  // turns each into the other.
+  const std::uint64_t difference = ((bits_ >> (4*index1)) ^ (bits_ >> (4*index2))) & 0xF;
+  return fromBits(bits_ ^ (difference << (4*index1)) ^ (difference << (4*index2)));
+}
+
+int PackedPuzzleState::getAdjacentStates(PackedPuzzleState adjacentStates[4]) const {
+  const int blankIdx = getBlankIndex();
+  int count = 0;
+  if (blankIdx >= 3) adjacentStates[count++] = swapped(blankIdx, blankIdx-3);
+  if (blankIdx <= 5) adjacentStates[count++] = swapped(blankIdx, blankIdx+3);
+  if (blankIdx % 3 != 0) adjacentStates[count++] = swapped(blankIdx, blankIdx-1);
+  if (blankIdx % 3 != 2) adjacentStates[count++] = swapped(blankIdx, blankIdx+1);
+  return count;
+}
+
+// ========================================================================
+//   puzzleRankBFS
+// ========================================================================
+
+// The same search as puzzleBFS (see GraphSearchExercises.cpp), but with the
+// states packed, and the search records in arrays indexed by rank:
+//
+// - pred: the rank of each state's predecessor, or UNVISITED. This is also
+//   the visited set.
+// - exploreQ: the packed states to explore, read from the front with a
+//   moving index. Each state is added at most once, so it never holds more
+//   than RANK_COUNT states.
+//
+// Like in GridBFS, we don't record every state's distance. Instead we go
+// through the queue one distance at a time, and levelEnd marks where the
+// states at the current distance end.
+std::list<PuzzleState> puzzleRankBFS(const PuzzleState& start, const PuzzleState& goal) {
+
+  constexpr int maxDist = 35;
+  constexpr std::uint32_t UNVISITED = std::numeric_limits<std::uint32_t>::max();
+
+  const PackedPuzzleState packedStart(start);
+  const PackedPuzzleState packedGoal(goal);
+  const std::uint32_t startRank = packedStart.rank();
+  const std::uint32_t goalRank = packedGoal.rank();
+
+  std::vector<std::uint32_t> pred(PackedPuzzleState::RANK_COUNT, UNVISITED);
+  std::vector<PackedPuzzleState> exploreQ;
+  // Only half of the states can be reached from any start.
+  exploreQ.reserve(PackedPuzzleState::RANK_COUNT / 2);
+  std::size_t exploreQFront = 0;
+
+  pred[startRank] = startRank;
+  exploreQ.push_back(packedStart);
+
+  bool foundGoal = (startRank == goalRank);
+  bool tooManySteps = false;
+  int curDist = 0;
+  std::size_t levelEnd = exploreQ.size();
+  PackedPuzzleState neighbors[4];
+
+  while (exploreQFront < exploreQ.size() && !foundGoal && !tooManySteps) {
+    if (exploreQFront == levelEnd) {
+      curDist++;
+      levelEnd = exploreQ.size();
+    }
+    const PackedPuzzleState curState = exploreQ[exploreQFront++];
+    const std::uint32_t curRank = curState.rank();
+    const int neighborCount = curState.getAdjacentStates(neighbors);
+
+    for (int i = 0; i < neighborCount; i++) {
+      const std::uint32_t neighborRank = neighbors[i].rank();
+      if (pred[neighborRank] != UNVISITED) continue;
+
+      pred[neighborRank] = curRank;
+      exploreQ.push_back(neighbors[i]);
+
+      if (curDist + 1 > maxDist) {
+        tooManySteps = true;
+        break;
+      }
+
+      if (neighborRank == goalRank) {
+        foundGoal = true;
+        break;
+      }
+    }
+  }
+
+  if (tooManySteps) {
+    std::cout << "puzzleRankBFS warning: Could not reach goal within the maximum allowed steps.\n (This may be expected if no path exists.)" << std::endl << std::endl;
+    return std::list<PuzzleState>();
+  }
+
+  if (!foundGoal) {
+    std::cout << "puzzleRankBFS warning: Could not reach goal. (This may be expected\n if no path exists.)" << std::endl << std::endl;
+    return std::list<PuzzleState>();
+  }
+
+  std::list<PuzzleState> path;
+  std::uint32_t cur = goalRank;
+  path.push_front(PackedPuzzleState::unrank(cur).toPuzzleState());
+  while (pred[cur] != cur) {
+    cur = pred[cur];
+    path.push_front(PackedPuzzleState::unrank(cur).toPuzzleState());
+  }
+  return path;
+}
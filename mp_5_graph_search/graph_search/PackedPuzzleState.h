@@ -0,0 +1,90 @@
+/**
+ * @file PackedPuzzleState.h
+ * University of Illinois CS 400, MOOC 3, Week 3: Graph Search
+ *
+ * An 8 puzzle state packed into 64 bits, with a perfect hash.
+ *
+**/
+
+#pragma once
+
+#include <array> // for std::array
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t, std::uint32_t
+#include <functional> // for std::hash
+
+#include "PuzzleState.h"
+
+// A PuzzleState holds 9 ints, 36 bytes, and puzzleBFS copies it into four
+// different hash tables for every state it visits, each time hashing it by
+// building its string representation. A PackedPuzzleState holds the same
+// information in one 64-bit integer: 4 bits per tile, with the tile at
+// index i (minus one, so 0 through 8) in bits 4i through 4i+3. That's the
+// same layout packPuzzleTiles uses in PuzzleSolvers.h.
+//
+// Each state also has a "rank": its position in the list of all 9! = 362880
+// arrangements of the tiles, in dictionary order. This is computed with the
+// Lehmer code: for each tile from left to right, count how many smaller
+// tiles are still to its right; those counts are the digits of the rank in
+// the "factorial number system", where the place values are 8!, 7!, ... 1!.
+// Since every state has a different rank, and every rank is used, a search
+// can keep its records in plain arrays of 9! entries indexed by rank,
+// instead of hash tables.
+class PackedPuzzleState {
+public:
+  // The number of possible arrangements, and so of ranks.
+  static constexpr std::uint32_t RANK_COUNT = 362880;
+
+  // The solved state.
+  PackedPuzzleState();
+
+  // Throws std::runtime_error if the data isn't a valid puzzle state.
+  explicit PackedPuzzleState(const std::array<int, 9>& data);
+  // (A PuzzleState is always valid, so there's no need to check it again.)
+  explicit PackedPuzzleState(const PuzzleState& state) : bits_(pack(state.getData())) {}
+
+  PuzzleState toPuzzleState() const { return PuzzleState(getData()); }
+  std::array<int, 9> getData() const;
+
+  std::uint64_t getBits() const { return bits_; }
+
+  // Make a state from bits returned by getBits. (They aren't checked.)
+  static PackedPuzzleState fromBits(std::uint64_t bits) {
+    PackedPuzzleState state;
+    state.bits_ = bits;
+    return state;
+  }
+
+  // The tile at an index, from 1 to 9, where 9 is the blank.
+  int tileAt(int index) const { return static_cast<int>((bits_ >> (4*index)) & 0xF) + 1; }
+  int getBlankIndex() const;
+
+  // The Lehmer rank, from 0 (the solved state) to RANK_COUNT-1, and back.
+  std::uint32_t rank() const;
+  static PackedPuzzleState unrank(std::uint32_t rank);
+
+  // Fill adjacentStates with the states one move away, in the same order as
+  // PuzzleState::getAdjacentStates, and return how many there are.
+  int getAdjacentStates(PackedPuzzleState adjacentStates[4]) const;
+
+  bool operator==(const PackedPuzzleState& other) const { return bits_ == other.bits_; }
+  bool operator!=(const PackedPuzzleState& other) const { return bits_ != other.bits_; }
+
+private:
+  std::uint64_t bits_;
+
+  static std::uint64_t pack(const std::array<int, 9>& data);
+
+  // Swap the tiles at two indices.
+  PackedPuzzleState swapped(int index1, int index2) const;
+};
+
+// The packed bits already identify the state, so they make a good hash.
+namespace std {
+  template <>
+  struct hash<PackedPuzzleState> {
+    std::size_t operator() (const PackedPuzzleState& puzzle) const {
+      return std::hash<std::uint64_t>()(puzzle.getBits());
+    }
+  };
+}
@@ -0,0 +1,379 @@
+/**
+ * @file PuzzleSolvers.cpp
+ * University of Illinois CS 400, MOOC 3, Week 3: Graph Search
+ *
+ * Informed search (A* and IDA*) for sliding tile puzzles.
+ *
+**/
+
+#include <algorithm> // for std::min, std::max, std::reverse, std::sort
+#include <cstdlib> // for std::abs
+#include <iostream> // for std::cout
+#include <limits> // for std::numeric_limits
+#include <queue> // for std::priority_queue
+#include <stdexcept> // for std::runtime_error
+#include <unordered_map> // for std::unordered_map
+
+#include "GraphSearchCommon.h"
+
+// ========================================================================
+//   PuzzleHeuristic
+// ========================================================================
+
+template <int WIDTH>
+PuzzleHeuristic<WIDTH>::PuzzleHeuristic(const PuzzleTiles<WIDTH>& goal) : goalRow_(), goalCol_() {
+  for (int i = 0; i < WIDTH*WIDTH; i++) {
+    goalRow_[goal[i]] = i / WIDTH;
+    goalCol_[goal[i]] = i % WIDTH;
+  }
+}
+
+template <int WIDTH>
+int PuzzleHeuristic<WIDTH>::manhattanDistance(const PuzzleTiles<WIDTH>& tiles) const {
+  int total = 0;
+  for (int i = 0; i < WIDTH*WIDTH; i++) {
+    // The blank isn't a tile, so it doesn't count.
+    if (WIDTH*WIDTH == tiles[i]) continue;
+    total += std::abs(i / WIDTH - goalRow_[tiles[i]]) + std::abs(i % WIDTH - goalCol_[tiles[i]]);
+  }
+  return total;
+}
+
+// Given the goal positions of the tiles along one line, in the order they
+// are in now, return how many of them have to leave the line so that the
+// rest are in the right order. That's the count minus the length of the
+// longest increasing subsequence. (Counting the pairs that are out of order
+// would overestimate: for three tiles in reverse order, that's three pairs,
+// but moving two tiles out of the way is enough.)
+static int tilesOutOfOrder(const int* goalPositions, int count) {
+  int longest = 0;
+  int longestEndingAt[16];
+  for (int i = 0; i < count; i++) {
+    longestEndingAt[i] = 1;
+    for (int j = 0; j < i; j++) {
+      if (goalPositions[j] < goalPositions[i]) {
+        longestEndingAt[i] = std::max(longestEndingAt[i], longestEndingAt[j] + 1);
+      }
+    }
+    longest = std::max(longest, longestEndingAt[i]);
+  }
+  return count - longest;
+}
+
+template <int WIDTH>
+int PuzzleHeuristic<WIDTH>::linearConflicts(const PuzzleTiles<WIDTH>& tiles) const {
+  int extraMoves = 0;
+  int goalPositions[WIDTH];
+  for (int line = 0; line < WIDTH; line++) {
+    // Tiles in row "line" that belong in that row, by goal column.
+    int count = 0;
+    for (int col = 0; col < WIDTH; col++) {
+      const int tile = tiles[line*WIDTH + col];
+      if (tile != WIDTH*WIDTH && goalRow_[tile] == line) goalPositions[count++] = goalCol_[tile];
+    }
+    extraMoves += 2 * tilesOutOfOrder(goalPositions, count);
+
+    // Tiles in column "line" that belong in that column, by goal row.
+    count = 0;
+    for (int row = 0; row < WIDTH; row++) {
+      const int tile = tiles[row*WIDTH + line];
+      if (tile != WIDTH*WIDTH && goalCol_[tile] == line) goalPositions[count++] = goalRow_[tile];
+    }
+    extraMoves += 2 * tilesOutOfOrder(goalPositions, count);
+  }
+  return extraMoves;
+}
+
+// ========================================================================
+//   Puzzle helpers
+// ========================================================================
+
+template <int WIDTH>
+bool isValidPuzzle(const PuzzleTiles<WIDTH>& tiles) {
+  PuzzleTiles<WIDTH> sorted = tiles;
+  std::sort(sorted.begin(), sorted.end());
+  for (int i = 0; i < WIDTH*WIDTH; i++) {
+    if (sorted[i] != i+1) return false;
+  }
+  return true;
+}
+
+// The parity that sliding moves can't change. Each move swaps the blank with
+// a tile, which changes the parity of the number of "inversions" (pairs of
+// tiles in the wrong order, ignoring the blank) only when the blank moves
+// up or down, and then by WIDTH-1 swaps. For odd widths that's an even
+// number, so the inversion count's parity never changes. For even widths it
+// flips every time the blank changes rows, so we add the blank's row.
+template <int WIDTH>
+static int puzzleParity(const PuzzleTiles<WIDTH>& tiles) {
+  int inversions = 0;
+  int blankRow = 0;
+  for (int i = 0; i < WIDTH*WIDTH; i++) {
+    if (WIDTH*WIDTH == tiles[i]) {
+      blankRow = i / WIDTH;
+      continue;
+    }
+    for (int j = i+1; j < WIDTH*WIDTH; j++) {
+      if (tiles[j] != WIDTH*WIDTH && tiles[j] < tiles[i]) inversions++;
+    }
+  }
+  return (inversions + ((WIDTH % 2) ? 0 : blankRow)) % 2;
+}
+
+template <int WIDTH>
+bool isSolvable(const PuzzleTiles<WIDTH>& start, const PuzzleTiles<WIDTH>& goal) {
+  return puzzleParity<WIDTH>(start) == puzzleParity<WIDTH>(goal);
+}
+
+template <int WIDTH>
+std::uint64_t packPuzzleTiles(const PuzzleTiles<WIDTH>& tiles) {
+  static_assert(WIDTH*WIDTH <= 16, "packPuzzleTiles: at most 16 tiles fit in 64 bits");
+  std::uint64_t packed = 0;
+  for (int i = 0; i < WIDTH*WIDTH; i++) {
+    packed |= static_cast<std::uint64_t>(tiles[i] - 1) << (4*i);
+  }
+  return packed;
+}
+
+template <int WIDTH>
+PuzzleTiles<WIDTH> unpackPuzzleTiles(std::uint64_t packed) {
+  PuzzleTiles<WIDTH> tiles;
+  for (int i = 0; i < WIDTH*WIDTH; i++) {
+    tiles[i] = static_cast<int>((packed >> (4*i)) & 0xF) + 1;
+  }
+  return tiles;
+}
+
+template <int WIDTH>
+static int blankIndexOf(const PuzzleTiles<WIDTH>& tiles) {
+  for (int i = 0; i < WIDTH*WIDTH; i++) {
+    if (WIDTH*WIDTH == tiles[i]) return i;
+  }
+  throw std::runtime_error("blankIndexOf: no blank; invalid puzzle state");
+}
+
+// The squares the blank at blankIdx can move to, in the same order as
+// PuzzleState::getAdjacentStates (up, down, left, right). Returns how many
+// there are.
+template <int WIDTH>
+static int blankMoves(int blankIdx, int moves[4]) {
+  int count = 0;
+  if (blankIdx >= WIDTH) moves[count++] = blankIdx - WIDTH;
+  if (blankIdx < WIDTH*(WIDTH-1)) moves[count++] = blankIdx + WIDTH;
+  if (blankIdx % WIDTH != 0) moves[count++] = blankIdx - 1;
+  if (blankIdx % WIDTH != WIDTH-1) moves[count++] = blankIdx + 1;
+  return count;
+}
+
+template <int WIDTH>
+static void checkPuzzles(const PuzzleTiles<WIDTH>& start, const PuzzleTiles<WIDTH>& goal) {
+  if (!isValidPuzzle<WIDTH>(start)) throw std::runtime_error("Puzzle solver: invalid start");
+  if (!isValidPuzzle<WIDTH>(goal)) throw std::runtime_error("Puzzle solver: invalid goal");
+}
+
+// ========================================================================
+//   A*
+// ========================================================================
+
+template <int WIDTH>
+std::vector<PuzzleTiles<WIDTH>> aStarSolve(const PuzzleTiles<WIDTH>& start, const PuzzleTiles<WIDTH>& goal, PuzzleSearchStats* stats) {
+  checkPuzzles<WIDTH>(start, goal);
+  PuzzleSearchStats localStats;
+  if (!stats) stats = &localStats;
+  *stats = PuzzleSearchStats();
+  if (!isSolvable<WIDTH>(start, goal)) return std::vector<PuzzleTiles<WIDTH>>();
+
+  const PuzzleHeuristic<WIDTH> heuristic(goal);
+  const std::uint64_t goalKey = packPuzzleTiles<WIDTH>(goal);
+
+  // Every state we've reached, with the move count of the path it was
+  // reached by and the node it was reached from, so we can retrace the path.
+  struct Node {
+    std::uint64_t key;
+    int pred;
+    int dist;
+  };
+  std::vector<Node> nodes;
+  // The shortest known move count for each state.
+  std::unordered_map<std::uint64_t, int> bestDist;
+
+  // The open list, ordered by estimated total moves. Among equal estimates,
+  // we prefer the state that's further along, since it's probably closer
+  // to the goal.
+  struct OpenEntry {
+    int estimate;
+    int dist;
+    int node;
+    bool operator<(const OpenEntry& other) const {
+      return estimate > other.estimate || (estimate == other.estimate && dist < other.dist);
+    }
+  };
+  std::priority_queue<OpenEntry> open;
+
+  nodes.push_back(Node{packPuzzleTiles<WIDTH>(start), -1, 0});
+  bestDist[nodes[0].key] = 0;
+  open.push(OpenEntry{heuristic(start), 0, 0});
+
+  while (!open.empty()) {
+    const OpenEntry entry = open.top();
+    open.pop();
+    const Node node = nodes[entry.node];
+    // If we've found a shorter way to this state since this entry was
+    // added, skip it; the entry for the shorter way is in the list too.
+    if (bestDist[node.key] < node.dist) continue;
+
+    if (node.key == goalKey) {
+      std::vector<PuzzleTiles<WIDTH>> path;
+      for (int cur = entry.node; cur >= 0; cur = nodes[cur].pred) {
+        path.push_back(unpackPuzzleTiles<WIDTH>(nodes[cur].key));
+      }
+      std::reverse(path.begin(), path.end());
+      return path;
+    }
+
+    stats->expandedCount++;
+    PuzzleTiles<WIDTH> tiles = unpackPuzzleTiles<WIDTH>(node.key);
+    const int blankIdx = blankIndexOf<WIDTH>(tiles);
+    int moves[4];
+    const int moveCount = blankMoves<WIDTH>(blankIdx, moves);
+    for (int m = 0; m < moveCount; m++) {
+      std::swap(tiles[blankIdx], tiles[moves[m]]);
+      const std::uint64_t key = packPuzzleTiles<WIDTH>(tiles);
+      const int dist = node.dist + 1;
+      auto found = bestDist.find(key);
+      if (found == bestDist.end() || dist < found->second) {
+        bestDist[key] = dist;
+        nodes.push_back(Node{key, entry.node, dist});
+        open.push(OpenEntry{dist + heuristic(tiles), dist, static_cast<int>(nodes.size()) - 1});
+      }
+      std::swap(tiles[blankIdx], tiles[moves[m]]);
+    }
+  }
+
+  // Only reachable if the parity check is wrong.
+  return std::vector<PuzzleTiles<WIDTH>>();
+}
+
+// ========================================================================
+//   IDA*
+// ========================================================================
+
+// The depth-first part of IDA*. The current state is kept in "tiles" and
+// changed in place as we make and undo moves; "path" holds the states from
+// the start to the current one.
+template <int WIDTH>
+class IdaStarSearch {
+public:
+  static constexpr int FOUND = -1;
+  static constexpr int NOT_FOUND = std::numeric_limits<int>::max();
+
+  IdaStarSearch(const PuzzleTiles<WIDTH>& start, const PuzzleTiles<WIDTH>& goal, PuzzleSearchStats& stats)
+    : heuristic_(goal), goal_(goal), tiles_(start), stats_(stats) {
+    path_.push_back(start);
+  }
+
+  // Search every path whose estimated total is within the limit. Returns
+  // FOUND if the goal was reached (and path_ leads to it), or otherwise the
+  // smallest estimate that was over the limit, to use as the next limit.
+  int search(int dist, int limit, int blankIdx, int prevBlankIdx) {
+    const int estimate = dist + heuristic_(tiles_);
+    if (estimate > limit) return estimate;
+    if (tiles_ == goal_) return FOUND;
+
+    stats_.expandedCount++;
+    int nextLimit = NOT_FOUND;
+    int moves[4];
+    const int moveCount = blankMoves<WIDTH>(blankIdx, moves);
+    for (int m = 0; m < moveCount; m++) {
+      // Moving the blank straight back where it came from is never useful.
+      if (moves[m] == prevBlankIdx) continue;
+      std::swap(tiles_[blankIdx], tiles_[moves[m]]);
+      path_.push_back(tiles_);
+      const int result = search(dist + 1, limit, moves[m], blankIdx);
+      if (FOUND == result) return FOUND;
+      nextLimit = std::min(nextLimit, result);
+      path_.pop_back();
+      std::swap(tiles_[blankIdx], tiles_[moves[m]]);
+    }
+    return nextLimit;
+  }
+
+  std::vector<PuzzleTiles<WIDTH>> solve() {
+    const int startBlankIdx = blankIndexOf<WIDTH>(tiles_);
+    int limit = heuristic_(tiles_);
+    while (true) {
+      stats_.iterations++;
+      const int result = search(0, limit, startBlankIdx, -1);
+      if (FOUND == result) return path_;
+      if (NOT_FOUND == result) return std::vector<PuzzleTiles<WIDTH>>();
+      limit = result;
+    }
+  }
+
+private:
+  const PuzzleHeuristic<WIDTH> heuristic_;
+  const PuzzleTiles<WIDTH> goal_;
+  PuzzleTiles<WIDTH> tiles_;
+  std::vector<PuzzleTiles<WIDTH>> path_;
+  PuzzleSearchStats& stats_;
+};
+
+// In some versions of C++ we have to redeclare constant static members
+// at global scope like this to ensure that the linker doesn't give an error.
+template <int WIDTH>
+constexpr int IdaStarSearch<WIDTH>::FOUND;
+template <int WIDTH>
+constexpr int IdaStarSearch<WIDTH>::NOT_FOUND;
+
+template <int WIDTH>
+std::vector<PuzzleTiles<WIDTH>> idaStarSolve(const PuzzleTiles<WIDTH>& start, const PuzzleTiles<WIDTH>& goal, PuzzleSearchStats* stats) {
+  checkPuzzles<WIDTH>(start, goal);
+  PuzzleSearchStats localStats;
+  if (!stats) stats = &localStats;
+  *stats = PuzzleSearchStats();
+  // An unsolvable puzzle would make IDA* raise its limit forever.
+  if (!isSolvable<WIDTH>(start, goal)) return std::vector<PuzzleTiles<WIDTH>>();
+  IdaStarSearch<WIDTH> search(start, goal, *stats);
+  return search.solve();
+}
+
+// The templates are defined here rather than in the header, so we have to
+// list the versions that other files can use: the 8 puzzle and the 15 puzzle.
+template class PuzzleHeuristic<3>;
+template class PuzzleHeuristic<4>;
+template bool isValidPuzzle<3>(const PuzzleTiles<3>& tiles);
+template bool isValidPuzzle<4>(const PuzzleTiles<4>& tiles);
+template bool isSolvable<3>(const PuzzleTiles<3>& start, const PuzzleTiles<3>& goal);
+template bool isSolvable<4>(const PuzzleTiles<4>& start, const PuzzleTiles<4>& goal);
+template std::uint64_t packPuzzleTiles<3>(const PuzzleTiles<3>& tiles);
+template std::uint64_t packPuzzleTiles<4>(const PuzzleTiles<4>& tiles);
+template PuzzleTiles<3> unpackPuzzleTiles<3>(std::uint64_t packed);
+template PuzzleTiles<4> unpackPuzzleTiles<4>(std::uint64_t packed);
+template std::vector<PuzzleTiles<3>> aStarSolve<3>(const PuzzleTiles<3>& start, const PuzzleTiles<3>& goal, PuzzleSearchStats* stats);
+template std::vector<PuzzleTiles<4>> aStarSolve<4>(const PuzzleTiles<4>& start, const PuzzleTiles<4>& goal, PuzzleSearchStats* stats);
+template std::vector<PuzzleTiles<3>> idaStarSolve<3>(const PuzzleTiles<3>& start, const PuzzleTiles<3>& goal, PuzzleSearchStats* stats);
+template std::vector<PuzzleTiles<4>> idaStarSolve<4>(const PuzzleTiles<4>& start, const PuzzleTiles<4>& goal, PuzzleSearchStats* stats);
+
+// ========================================================================
+//   Solving PuzzleState puzzles
+// ========================================================================
+
+// Convert a solver's result to the same kind of path puzzleBFS returns.
+static std::list<PuzzleState> toPuzzleStatePath(const std::vector<PuzzleTiles<3>>& solution, const char* functionName) {
+  if (solution.empty()) {
+    std::cout << functionName << " warning: Could not reach goal. (The puzzle can't be solved.)" << std::endl << std::endl;
+  }
+  std::list<PuzzleState> path;
+  for (const PuzzleTiles<3>& tiles : solution) {
+    path.push_back(PuzzleState(tiles));
+  }
+  return path;
+}
+
+std::list<PuzzleState> puzzleAStar(const PuzzleState& start, const PuzzleState& goal, PuzzleSearchStats* stats) {
+  return toPuzzleStatePath(aStarSolve<3>(start.getData(), goal.getData(), stats), "puzzleAStar");
+}
+
+std::list<PuzzleState> puzzleIDAStar(const PuzzleState& start, const PuzzleState& goal, PuzzleSearchStats* stats) {
+  return toPuzzleStatePath(idaStarSolve<3>(start.getData(), goal.getData(), stats), "puzzleIDAStar");
+}
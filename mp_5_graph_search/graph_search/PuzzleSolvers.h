@@ -0,0 +1,109 @@
+/**
+ * @file PuzzleSolvers.h
+ * University of Illinois CS 400, MOOC 3, Week 3: Graph Search
+ *
+ * Informed search (A* and IDA*) for sliding tile puzzles.
+ *
+**/
+
+#pragma once
+
+#include <array> // for std::array
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <vector> // for std::vector
+
+// puzzleBFS explores the states of the 8 puzzle in order of how many moves
+// away from the start they are, without any idea of which direction the
+// goal is in. That means visiting nearly every state within the solution's
+// distance, which is most of the 181440 reachable states for a hard puzzle.
+// For the 15 puzzle (4x4 tiles), with about 10^13 reachable states, that
+// is hopeless.
+//
+// Informed search uses a "heuristic": an estimate of how many moves are
+// still needed to get from a state to the goal. As long as the heuristic
+// never overestimates (it's "admissible"), these searches still find a
+// shortest solution, but they can skip most states that are headed the
+// wrong way:
+//
+// - A* always explores the state with the smallest "moves so far plus
+//   estimated moves remaining". Like BFS, it has to remember every state it
+//   has seen.
+// - IDA* (iterative deepening A*) does a series of depth-first searches,
+//   each one only following moves while "moves so far plus estimated moves
+//   remaining" is within a limit, and raises the limit each time. It only
+//   needs to remember the current path, so it's the one to use for the 15
+//   puzzle, where A* runs out of memory on hard puzzles.
+//
+// The heuristic we use is the Manhattan distance (how many rows and columns
+// each tile is from its goal position, added up over all tiles) plus linear
+// conflicts (when two tiles are both in their goal row, but in the wrong
+// order, one of them has to leave the row and come back, which costs two
+// more moves that the Manhattan distance doesn't count).
+//
+// Everything here is templated on WIDTH, the number of tiles along each
+// side: 3 for the 8 puzzle and 4 for the 15 puzzle. As in PuzzleState, a
+// puzzle is an array of the tile numbers, reading the rows from left to
+// right, where the number WIDTH*WIDTH stands for the blank space.
+
+template <int WIDTH>
+using PuzzleTiles = std::array<int, WIDTH*WIDTH>;
+
+// Extra information about a search, for testing and measuring.
+struct PuzzleSearchStats {
+  // The number of states whose moves were explored.
+  std::size_t expandedCount = 0;
+  // The number of depth-first searches IDA* did (0 for A*).
+  int iterations = 0;
+};
+
+// -------------------------------------------------------------------
+// PuzzleHeuristic class
+// -------------------------------------------------------------------
+// Estimates the number of moves from a state to one goal state. The
+// estimate is never too high.
+template <int WIDTH>
+class PuzzleHeuristic {
+public:
+  explicit PuzzleHeuristic(const PuzzleTiles<WIDTH>& goal);
+
+  int manhattanDistance(const PuzzleTiles<WIDTH>& tiles) const;
+  int linearConflicts(const PuzzleTiles<WIDTH>& tiles) const;
+
+  int operator()(const PuzzleTiles<WIDTH>& tiles) const {
+    return manhattanDistance(tiles) + linearConflicts(tiles);
+  }
+
+private:
+  // The goal row and column of each tile, indexed by tile number.
+  std::array<int, WIDTH*WIDTH+1> goalRow_;
+  std::array<int, WIDTH*WIDTH+1> goalCol_;
+};
+
+// Whether the tiles are some arrangement of the numbers 1 through WIDTH*WIDTH.
+template <int WIDTH>
+bool isValidPuzzle(const PuzzleTiles<WIDTH>& tiles);
+
+// Whether the goal can be reached from the start by sliding tiles. Only half
+// of all arrangements can be reached from any given one: every move keeps a
+// certain "parity" of the arrangement the same, so the start and the goal
+// must have the same parity.
+template <int WIDTH>
+bool isSolvable(const PuzzleTiles<WIDTH>& start, const PuzzleTiles<WIDTH>& goal);
+
+// Pack a puzzle into 64 bits, with 4 bits per tile, for use as a hash key.
+// (This only fits puzzles with up to 16 tiles.)
+template <int WIDTH>
+std::uint64_t packPuzzleTiles(const PuzzleTiles<WIDTH>& tiles);
+template <int WIDTH>
+PuzzleTiles<WIDTH> unpackPuzzleTiles(std::uint64_t packed);
+
+// Find a shortest solution with A* or IDA*, returned as the sequence of
+// states from start to goal. If the puzzle can't be solved, the result is
+// empty. Throws std::runtime_error if either puzzle isn't valid.
+template <int WIDTH>
+std::vector<PuzzleTiles<WIDTH>> aStarSolve(const PuzzleTiles<WIDTH>& start, const PuzzleTiles<WIDTH>& goal,
+  PuzzleSearchStats* stats=nullptr);
+template <int WIDTH>
+std::vector<PuzzleTiles<WIDTH>> idaStarSolve(const PuzzleTiles<WIDTH>& start, const PuzzleTiles<WIDTH>& goal,
+  PuzzleSearchStats* stats=nullptr);
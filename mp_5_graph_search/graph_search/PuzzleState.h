@@ -19,6 +19,7 @@
 #include <string>
 #include <sstream> // for std::stringstream
 #include <functional> // for std::hash
+#include <cstdint> // for std::uint64_t
 
 // PuzzleState implements one state of the "8 puzzle", the sliding tile
 // puzzle played with 8 tiles on a 3x3 grid, where a tile is allowed to slide
@@ -347,12 +348,18 @@ namespace std {
   template <>
   struct hash<PuzzleState> {
     std::size_t operator() (const PuzzleState& puzzle) const {
-      // Create the unique string that compactly represents this puzzle state.
-      std::string dataString = puzzle.stringify();
-      // Get the default hashing function object for a std::string.
-      std::hash<std::string> stringHasher;
-      // Use the string hasher on our unique string.
-      return stringHasher(dataString);
+      // Pack the tiles into a single 64-bit integer, 4 bits per tile, which
+      // is unique for every puzzle state. This is much faster than making a
+      // string with stringify() and hashing that. (PackedPuzzleState.h uses
+      // the same idea to store whole puzzle states compactly.)
+      std::uint64_t packed = 0;
+      for (int tile : puzzle.getData()) {
+        packed = (packed << 4) | static_cast<std::uint64_t>(tile);
+      }
+      // Get the default hashing function object for a 64-bit integer.
+      std::hash<std::uint64_t> packedHasher;
+      // Use it on our unique number.
+      return packedHasher(packed);
     }
   };
 }
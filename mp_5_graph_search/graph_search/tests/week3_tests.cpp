@@ -5,12 +5,17 @@
 // Based on Catch2 unit testing framework
 
 #include <cstdlib>
+#include <climits>
 #include <stdexcept>
 #include <sstream>
 #include <chrono>
+#include <iterator>
 
 #include "../GraphSearchCommon.h"
 
+// IntPair is a std::pair, and Catch can't see the operator<< for it in
+// IntPair2.h when printing failed assertions, so let Catch print pairs itself.
+#define CATCH_CONFIG_ENABLE_PAIR_STRINGMAKER
 #include "../uiuc/catch/catch.hpp"
 
 // May be useful in writing some tests
@@ -599,3 +604,632 @@ TEST_CASE("Testing puzzleBFS on a random puzzle:", "[weight=1][ex3]") {
 }
 
 
+
+// ========================================================================
+// Tests: DenseGridGraph
+// ========================================================================
+
+// Make a rows x cols mesh of points starting at (0,0), with every possible edge.
+template <typename Graph>
+void insertMesh(Graph& graph, int rows, int cols) {
+  for (int row=0; row<rows; row++) {
+    for (int col=0; col<cols; col++) {
+      if (row+1 < rows) graph.insertEdge(IntPair(row,col), IntPair(row+1,col));
+      if (col+1 < cols) graph.insertEdge(IntPair(row,col), IntPair(row,col+1));
+    }
+  }
+}
+
+// Check that a path is made of edges of the graph, from start to goal.
+template <typename Graph>
+bool isPathInGraph(const std::list<IntPair>& path, const IntPair& start, const IntPair& goal, const Graph& graph) {
+  if (path.empty() || path.front() != start || path.back() != goal) return false;
+  auto prev = path.begin();
+  for (auto it = std::next(path.begin()); it != path.end(); ++it, ++prev) {
+    if (!graph.hasEdge(*prev, *it)) return false;
+  }
+  return true;
+}
+
+TEST_CASE("DenseGridGraph matches GridGraph:", "[weight=0]") {
+
+  GridGraph graph;
+  DenseGridGraph dense(IntPair(0,0), IntPair(6,5));
+  insertMesh(graph, 7, 6);
+  insertMesh(dense, 7, 6);
+
+  SECTION("Should count the same points and edges") {
+    REQUIRE(dense.countVertices() == graph.countVertices());
+    REQUIRE(dense.countEdges() == graph.countEdges());
+    REQUIRE(dense.countEdges() == 7*5 + 6*6);
+  }
+
+  SECTION("Should remove edges and points the same way") {
+    graph.removeEdge(IntPair(2,2), IntPair(2,3));
+    dense.removeEdge(IntPair(2,3), IntPair(2,2));
+    graph.removePoint(IntPair(4,4));
+    dense.removePoint(IntPair(4,4));
+    // Removing things that aren't there does nothing.
+    dense.removeEdge(IntPair(2,2), IntPair(2,3));
+    dense.removePoint(IntPair(4,4));
+    dense.removePoint(IntPair(50,50));
+
+    REQUIRE(!dense.hasEdge(IntPair(2,2), IntPair(2,3)));
+    REQUIRE(!dense.hasPoint(IntPair(4,4)));
+    REQUIRE(!dense.hasEdge(IntPair(3,4), IntPair(4,4)));
+    REQUIRE(dense.hasEdge(IntPair(3,4), IntPair(3,5)));
+    REQUIRE(dense.countVertices() == graph.countVertices());
+    REQUIRE(dense.countEdges() == graph.countEdges());
+    REQUIRE(dense.toGridGraph() == graph);
+    REQUIRE(DenseGridGraph(graph) == dense);
+  }
+
+  SECTION("Should reject bad edges and points outside the box") {
+    REQUIRE_THROWS_AS(dense.insertEdge(IntPair(0,0), IntPair(1,1)), std::runtime_error);
+    REQUIRE_THROWS_AS(dense.insertPoint(IntPair(7,0)), std::runtime_error);
+    REQUIRE_THROWS_AS(dense.insertEdge(IntPair(0,5), IntPair(0,6)), std::runtime_error);
+    REQUIRE(!dense.hasPoint(IntPair(-1,0)));
+    REQUIRE(!dense.hasEdge(IntPair(0,0), IntPair(-1,0)));
+  }
+
+  SECTION("Should support a box that doesn't start at (0,0)") {
+    DenseGridGraph shifted(IntPair(-3,10), IntPair(-1,12));
+    shifted.insertEdge(IntPair(-3,10), IntPair(-2,10));
+    shifted.insertEdge(IntPair(-1,12), IntPair(-1,11));
+    REQUIRE(shifted.countEdges() == 2);
+    REQUIRE(shifted.hasEdge(IntPair(-2,10), IntPair(-3,10)));
+    REQUIRE(shifted.getNeighbors(IntPair(-1,12)) == std::vector<IntPair>{IntPair(-1,11)});
+    REQUIRE(DenseGridGraph(shifted.toGridGraph()) == shifted);
+    // These differences overflow int when taken from a negative corner.
+    REQUIRE(!shifted.hasPoint(IntPair(INT_MAX,11)));
+    REQUIRE(!shifted.hasPoint(IntPair(-2,INT_MAX)));
+  }
+
+}
+
+TEST_CASE("graphBFS on a DenseGridGraph finds the same path lengths:", "[weight=0]") {
+
+  srand(400);
+  GridGraph graph;
+  insertMesh(graph, 20, 20);
+  // Knock out random edges to make a maze.
+  for (int i=0; i<300; i++) {
+    IntPair p1(rand() % 20, rand() % 20);
+    IntPair p2 = (rand() % 2) ? IntPair(p1.first+1, p1.second) : IntPair(p1.first, p1.second+1);
+    graph.removeEdge(p1, p2);
+  }
+  const DenseGridGraph dense(graph);
+
+  const IntPair start(0,0);
+  for (int row=0; row<20; row+=3) {
+    for (int col=0; col<20; col+=4) {
+      const IntPair goal(row,col);
+      std::list<IntPair> path = graphBFS(start, goal, graph);
+      std::list<IntPair> densePath = graphBFS(start, goal, dense);
+      REQUIRE(densePath.size() == path.size());
+      if (!path.empty()) {
+        REQUIRE(isPathInGraph(densePath, start, goal, dense));
+      }
+    }
+  }
+
+  REQUIRE_THROWS_AS(graphBFS(start, IntPair(30,30), dense), std::runtime_error);
+  REQUIRE(graphBFS(start, start, dense) == std::list<IntPair>{start});
+}
+
+// Roughly how much memory a GridGraph uses, counting the hash table
+// buckets and nodes of adjacencyMap and of every NeighborSet.
+static std::size_t approximateMemoryBytes(const GridGraph& graph) {
+  // Each node holds a next pointer, the element, and a saved hash value.
+  const std::size_t mapNodeBytes = sizeof(void*) + sizeof(std::pair<const IntPair, GridGraph::NeighborSet>) + sizeof(std::size_t);
+  const std::size_t setNodeBytes = sizeof(void*) + sizeof(IntPair) + sizeof(std::size_t);
+  std::size_t bytes = graph.adjacencyMap.bucket_count() * sizeof(void*) + graph.adjacencyMap.size() * mapNodeBytes;
+  for (const auto& kv : graph.adjacencyMap) {
+    bytes += kv.second.bucket_count() * sizeof(void*) + kv.second.size() * setNodeBytes;
+  }
+  return bytes;
+}
+
+// This is hidden because of the [.] tag. You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: GridGraph vs. DenseGridGraph", "[weight=0][.][bench]") {
+
+  const int SIZE = 300;
+  GridGraph graph;
+  DenseGridGraph dense(IntPair(0,0), IntPair(SIZE-1,SIZE-1));
+  insertMesh(graph, SIZE, SIZE);
+  insertMesh(dense, SIZE, SIZE);
+
+  std::cout << "Memory for a " << SIZE << "x" << SIZE << " mesh: GridGraph about "
+    << approximateMemoryBytes(graph) / 1024 << " KB, DenseGridGraph "
+    << dense.memoryBytes() / 1024 << " KB" << std::endl;
+
+  // A goal 99 steps away, just within graphBFS's limit of 100.
+  const IntPair start(SIZE/2, SIZE/2);
+  const IntPair goal(SIZE/2 + 50, SIZE/2 + 49);
+  const int REPEATS = 5;
+  std::list<IntPair> path;
+  std::list<IntPair> densePath;
+
+  auto startTime = std::chrono::steady_clock::now();
+  for (int i=0; i<REPEATS; i++) {
+    path = graphBFS(start, goal, graph);
+  }
+  auto gridMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+  startTime = std::chrono::steady_clock::now();
+  for (int i=0; i<REPEATS; i++) {
+    densePath = graphBFS(start, goal, dense);
+  }
+  auto denseMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+  std::cout << "graphBFS x" << REPEATS << ": GridGraph " << gridMs << " ms, DenseGridGraph " << denseMs << " ms" << std::endl;
+  REQUIRE(path.size() == 100);
+  REQUIRE(densePath.size() == 100);
+}
+
+// ========================================================================
+// Tests: GridBFS
+// ========================================================================
+
+TEST_CASE("GridBFS finds shortest paths without new memory per search:", "[weight=0]") {
+
+  srand(447);
+  const int SIZE = 40;
+  DenseGridGraph dense(IntPair(0,0), IntPair(SIZE-1,SIZE-1));
+  insertMesh(dense, SIZE, SIZE);
+  for (int i=0; i<600; i++) {
+    IntPair p1(rand() % SIZE, rand() % SIZE);
+    IntPair p2 = (rand() % 2) ? IntPair(p1.first+1, p1.second) : IntPair(p1.first, p1.second+1);
+    dense.removeEdge(p1, p2);
+  }
+
+  GridBFS bfs;
+  std::vector<IntPair> path;
+
+  SECTION("Should agree with graphBFS on path lengths") {
+    for (int i=0; i<50; i++) {
+      const IntPair start(rand() % SIZE, rand() % SIZE);
+      const IntPair goal(rand() % SIZE, rand() % SIZE);
+      // graphBFS prints a warning for every unreachable goal, which isn't
+      // useful here, so ask it for long paths only when GridBFS found one.
+      const GridBFS::Result result = bfs.findPath(dense, start, goal, path);
+      if (GridBFS::Result::FOUND == result) {
+        std::list<IntPair> expected = graphBFS(start, goal, dense, SIZE*SIZE);
+        REQUIRE(path.size() == expected.size());
+        REQUIRE(isPathInGraph(std::list<IntPair>(path.begin(), path.end()), start, goal, dense));
+      }
+      else {
+        REQUIRE(GridBFS::Result::UNREACHABLE == result);
+        REQUIRE(path.empty());
+      }
+    }
+  }
+
+  SECTION("Should report a goal beyond maxDist") {
+    DenseGridGraph line(IntPair(0,0), IntPair(0,9));
+    insertMesh(line, 1, 10);
+    REQUIRE(bfs.findPath(line, IntPair(0,0), IntPair(0,9), path, 8) == GridBFS::Result::TOO_MANY_STEPS);
+    REQUIRE(path.empty());
+    REQUIRE(bfs.findPath(line, IntPair(0,0), IntPair(0,9), path, 9) == GridBFS::Result::FOUND);
+    REQUIRE(path.size() == 10);
+    std::vector<int> pathIds;
+    REQUIRE(bfs.findPathIds(line, 3, 3, pathIds) == GridBFS::Result::FOUND);
+    REQUIRE(pathIds == std::vector<int>{3});
+    REQUIRE_THROWS_AS(bfs.findPathIds(line, 0, 10, pathIds), std::runtime_error);
+  }
+
+  SECTION("Should not need more memory after the first searches") {
+    // Warm up with a search that visits the whole graph and a long path.
+    bfs.findPath(dense, IntPair(0,0), IntPair(SIZE-1,SIZE-1), path);
+    path.reserve(SIZE*SIZE);
+    const std::size_t bytes = bfs.memoryBytes();
+    const IntPair* pathData = path.data();
+    for (int i=0; i<50; i++) {
+      bfs.findPath(dense, IntPair(rand() % SIZE, rand() % SIZE), IntPair(rand() % SIZE, rand() % SIZE), path);
+      REQUIRE(bfs.memoryBytes() == bytes);
+    }
+    REQUIRE(path.data() == pathData);
+  }
+
+}
+
+// This is hidden because of the [.] tag. You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: graphBFS vs. a reused GridBFS", "[weight=0][.][bench]") {
+
+  const int SIZE = 1000;
+  DenseGridGraph dense(IntPair(0,0), IntPair(SIZE-1,SIZE-1));
+  insertMesh(dense, SIZE, SIZE);
+
+  // Many short queries, where setting up the search records dominates.
+  srand(400);
+  std::vector<IntPairPair> queries;
+  for (int i=0; i<200; i++) {
+    const IntPair start(rand() % (SIZE-10), rand() % (SIZE-10));
+    queries.push_back(IntPairPair(start, IntPair(start.first + rand() % 10, start.second + rand() % 10)));
+  }
+
+  std::size_t totalSteps = 0;
+  auto startTime = std::chrono::steady_clock::now();
+  for (const IntPairPair& query : queries) {
+    totalSteps += graphBFS(query.first, query.second, dense).size();
+  }
+  auto graphBFSMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+  GridBFS bfs;
+  std::vector<IntPair> path;
+  std::size_t reusedSteps = 0;
+  startTime = std::chrono::steady_clock::now();
+  for (const IntPairPair& query : queries) {
+    bfs.findPath(dense, query.first, query.second, path);
+    reusedSteps += path.size();
+  }
+  auto gridBFSMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+  std::cout << queries.size() << " short queries on a " << SIZE << "x" << SIZE << " mesh: graphBFS "
+    << graphBFSMs << " ms, reused GridBFS " << gridBFSMs << " ms" << std::endl;
+  REQUIRE(reusedSteps == totalSteps);
+}
+
+// ========================================================================
+// Tests: bidirectional BFS
+// ========================================================================
+
+// Check that a path is a chain of adjacent puzzle states from start to goal.
+static bool isPuzzlePath(const std::list<PuzzleState>& path, const PuzzleState& start, const PuzzleState& goal) {
+  if (path.empty() || path.front() != start || path.back() != goal) return false;
+  auto prev = path.begin();
+  for (auto it = std::next(path.begin()); it != path.end(); ++it, ++prev) {
+    if (!prev->isAdjacent(*it)) return false;
+  }
+  return true;
+}
+
+TEST_CASE("graphBidirectionalBFS finds the same path lengths as graphBFS:", "[weight=0]") {
+
+  srand(448);
+  GridGraph graph;
+  insertMesh(graph, 15, 15);
+  for (int i=0; i<150; i++) {
+    IntPair p1(rand() % 15, rand() % 15);
+    IntPair p2 = (rand() % 2) ? IntPair(p1.first+1, p1.second) : IntPair(p1.first, p1.second+1);
+    graph.removeEdge(p1, p2);
+  }
+
+  const IntPair start(7,7);
+  for (int row=0; row<15; row+=2) {
+    for (int col=0; col<15; col+=3) {
+      const IntPair goal(row,col);
+      std::list<IntPair> path = graphBFS(start, goal, graph);
+      std::list<IntPair> bidirectionalPath = graphBidirectionalBFS(start, goal, graph);
+      REQUIRE(bidirectionalPath.size() == path.size());
+      if (!path.empty()) {
+        REQUIRE(isPathInGraph(bidirectionalPath, start, goal, graph));
+      }
+    }
+  }
+
+  REQUIRE(graphBidirectionalBFS(start, start, graph) == std::list<IntPair>{start});
+  REQUIRE_THROWS_AS(graphBidirectionalBFS(start, IntPair(20,20), graph), std::runtime_error);
+}
+
+TEST_CASE("puzzleBidirectionalBFS finds the same solution lengths as puzzleBFS:", "[weight=0]") {
+
+  srand(480);
+  const PuzzleState puzzle_goal({1,2,3,4,5,6,7,8,9});
+
+  SECTION("Should find shortest solutions") {
+    for (int i=0; i<5; i++) {
+      const PuzzleState puzzle_start = PuzzleState::randomizePuzzle(puzzle_goal, 18);
+      std::list<PuzzleState> path = puzzleBFS(puzzle_start, puzzle_goal);
+      std::list<PuzzleState> bidirectionalPath = puzzleBidirectionalBFS(puzzle_start, puzzle_goal);
+      REQUIRE(bidirectionalPath.size() == path.size());
+      REQUIRE(isPuzzlePath(bidirectionalPath, puzzle_start, puzzle_goal));
+    }
+  }
+
+  SECTION("Should give up quickly when the puzzle can't be solved") {
+    // Every 8 puzzle state with the same "parity" as the start can be
+    // reached from it, and that's 9!/2 = 181440 states.
+    const PuzzleState puzzle_start({1,3,2,4,5,6,7,8,9});
+    BidirectionalBFSStats stats;
+    std::list<PuzzleState> path = puzzleBidirectionalBFS(puzzle_start, puzzle_goal, &stats);
+    REQUIRE(path.empty());
+    REQUIRE(stats.tooManySteps);
+    REQUIRE(stats.visitedCount < 181440 / 2);
+  }
+
+}
+
+// This is hidden because of the [.] tag. You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: puzzleBFS vs. puzzleBidirectionalBFS", "[weight=0][.][bench]") {
+
+  const PuzzleState puzzle_goal({1,2,3,4,5,6,7,8,9});
+  // One of the hardest 8 puzzles (31 moves), and one that can't be solved.
+  const std::vector<PuzzleState> starts = {PuzzleState({8,6,7,2,5,4,3,9,1}), PuzzleState({1,3,2,4,5,6,7,8,9})};
+
+  for (const PuzzleState& puzzle_start : starts) {
+    auto startTime = std::chrono::steady_clock::now();
+    std::list<PuzzleState> path = puzzleBFS(puzzle_start, puzzle_goal);
+    auto bfsMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    BidirectionalBFSStats stats;
+    startTime = std::chrono::steady_clock::now();
+    std::list<PuzzleState> bidirectionalPath = puzzleBidirectionalBFS(puzzle_start, puzzle_goal, &stats);
+    auto bidirectionalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::cout << puzzle_start.stringify() << ": puzzleBFS " << bfsMs << " ms, puzzleBidirectionalBFS "
+      << bidirectionalMs << " ms (" << stats.visitedCount << " states visited)" << std::endl;
+    REQUIRE(bidirectionalPath.size() == path.size());
+  }
+}
+
+// ========================================================================
+// Tests: A* and IDA*
+// ========================================================================
+
+// Make random moves from a solved 15 puzzle, without undoing the last move.
+static PuzzleTiles<4> scramble15Puzzle(int moveCount) {
+  PuzzleTiles<4> tiles = {1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16};
+  int blankIdx = 15;
+  int prevBlankIdx = -1;
+  for (int i=0; i<moveCount; i++) {
+    std::vector<int> moves;
+    if (blankIdx >= 4) moves.push_back(blankIdx-4);
+    if (blankIdx < 12) moves.push_back(blankIdx+4);
+    if (blankIdx % 4 != 0) moves.push_back(blankIdx-1);
+    if (blankIdx % 4 != 3) moves.push_back(blankIdx+1);
+    int next;
+    do {
+      next = moves[rand() % moves.size()];
+    } while (next == prevBlankIdx);
+    std::swap(tiles[blankIdx], tiles[next]);
+    prevBlankIdx = blankIdx;
+    blankIdx = next;
+  }
+  return tiles;
+}
+
+// Check that each state in a solution is one move from the one before.
+template <int WIDTH>
+bool isTilesPath(const std::vector<PuzzleTiles<WIDTH>>& path) {
+  for (std::size_t i=1; i<path.size(); i++) {
+    int differences = 0;
+    int blankIdx = -1;
+    int otherIdx = -1;
+    for (int j=0; j<WIDTH*WIDTH; j++) {
+      if (path[i-1][j] == path[i][j]) continue;
+      differences++;
+      if (WIDTH*WIDTH == path[i-1][j]) blankIdx = j;
+      else otherIdx = j;
+    }
+    if (differences != 2 || blankIdx < 0 || otherIdx < 0) return false;
+    const int distance = std::abs(blankIdx/WIDTH - otherIdx/WIDTH) + std::abs(blankIdx%WIDTH - otherIdx%WIDTH);
+    if (distance != 1) return false;
+  }
+  return true;
+}
+
+TEST_CASE("PuzzleHeuristic estimates without overestimating:", "[weight=0]") {
+
+  const PuzzleTiles<3> goal = {1,2,3,4,5,6,7,8,9};
+  const PuzzleHeuristic<3> heuristic(goal);
+
+  SECTION("Should count Manhattan distance and linear conflicts") {
+    REQUIRE(heuristic(goal) == 0);
+    // 1 and 2 are swapped in their goal row: 2 moves by Manhattan distance,
+    // plus 2 for the conflict.
+    REQUIRE(heuristic.manhattanDistance({2,1,3,4,5,6,7,8,9}) == 2);
+    REQUIRE(heuristic.linearConflicts({2,1,3,4,5,6,7,8,9}) == 2);
+    // A whole row reversed only needs two tiles to leave it, not three.
+    REQUIRE(heuristic.linearConflicts({3,2,1,4,5,6,7,8,9}) == 4);
+    // The same in a column.
+    REQUIRE(heuristic.linearConflicts({4,2,3,1,5,6,7,8,9}) == 2);
+  }
+
+  SECTION("Should never be more than the real number of moves") {
+    srand(490);
+    for (int i=0; i<20; i++) {
+      const PuzzleState puzzle_start = PuzzleState::randomizePuzzle(PuzzleState(goal), 25);
+      std::list<PuzzleState> path = puzzleBidirectionalBFS(puzzle_start, PuzzleState(goal));
+      REQUIRE(heuristic(puzzle_start.getData()) <= static_cast<int>(path.size()) - 1);
+    }
+  }
+
+  SECTION("Should tell which puzzles can be solved") {
+    REQUIRE(isSolvable<3>({9,2,6,1,3,5,4,7,8}, goal));
+    REQUIRE(!isSolvable<3>({1,3,2,4,5,6,7,8,9}, goal));
+    const PuzzleTiles<4> goal15 = {1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16};
+    REQUIRE(isSolvable<4>(scramble15Puzzle(31), goal15));
+    REQUIRE(!isSolvable<4>({1,2,3,4,5,6,7,8,9,10,11,12,13,15,14,16}, goal15));
+  }
+
+}
+
+TEST_CASE("puzzleAStar and puzzleIDAStar find the same solution lengths as puzzleBFS:", "[weight=0]") {
+
+  srand(491);
+  const PuzzleState puzzle_goal({1,2,3,4,5,6,7,8,9});
+
+  SECTION("Should find shortest solutions") {
+    for (int i=0; i<5; i++) {
+      const PuzzleState puzzle_start = PuzzleState::randomizePuzzle(puzzle_goal, 20);
+      std::list<PuzzleState> path = puzzleBFS(puzzle_start, puzzle_goal);
+      std::list<PuzzleState> aStarPath = puzzleAStar(puzzle_start, puzzle_goal);
+      std::list<PuzzleState> idaStarPath = puzzleIDAStar(puzzle_start, puzzle_goal);
+      REQUIRE(aStarPath.size() == path.size());
+      REQUIRE(idaStarPath.size() == path.size());
+      REQUIRE(isPuzzlePath(aStarPath, puzzle_start, puzzle_goal));
+      REQUIRE(isPuzzlePath(idaStarPath, puzzle_start, puzzle_goal));
+    }
+  }
+
+  SECTION("Should expand far fewer states on a hard puzzle") {
+    const PuzzleState puzzle_start({8,6,7,2,5,4,3,9,1});
+    PuzzleSearchStats aStarStats;
+    PuzzleSearchStats idaStarStats;
+    REQUIRE(puzzleAStar(puzzle_start, puzzle_goal, &aStarStats).size() == 32);
+    REQUIRE(puzzleIDAStar(puzzle_start, puzzle_goal, &idaStarStats).size() == 32);
+    // BFS would explore almost all of the 181440 reachable states.
+    REQUIRE(aStarStats.expandedCount < 181440 / 4);
+    REQUIRE(idaStarStats.iterations > 0);
+  }
+
+  SECTION("Should give up right away when the puzzle can't be solved") {
+    PuzzleSearchStats stats;
+    REQUIRE(puzzleAStar(PuzzleState({1,3,2,4,5,6,7,8,9}), puzzle_goal, &stats).empty());
+    REQUIRE(stats.expandedCount == 0);
+    REQUIRE(puzzleIDAStar(PuzzleState({1,3,2,4,5,6,7,8,9}), puzzle_goal, &stats).empty());
+    REQUIRE(stats.expandedCount == 0);
+    REQUIRE(puzzleAStar(puzzle_goal, puzzle_goal) == std::list<PuzzleState>{puzzle_goal});
+  }
+
+  SECTION("Should solve the 15 puzzle") {
+    const PuzzleTiles<4> goal15 = {1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16};
+    for (int i=0; i<3; i++) {
+      const PuzzleTiles<4> start15 = scramble15Puzzle(30);
+      std::vector<PuzzleTiles<4>> aStarPath = aStarSolve<4>(start15, goal15);
+      std::vector<PuzzleTiles<4>> idaStarPath = idaStarSolve<4>(start15, goal15);
+      REQUIRE(aStarPath.size() == idaStarPath.size());
+      REQUIRE(aStarPath.size() <= 31);
+      REQUIRE(idaStarPath.front() == start15);
+      REQUIRE(idaStarPath.back() == goal15);
+      REQUIRE(isTilesPath<4>(aStarPath));
+      REQUIRE(isTilesPath<4>(idaStarPath));
+    }
+    REQUIRE_THROWS_AS(aStarSolve<4>({1,1,3,4,5,6,7,8,9,10,11,12,13,14,15,16}, goal15), std::runtime_error);
+  }
+
+}
+
+// This is hidden because of the [.] tag. You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: puzzleBFS vs. A* and IDA*", "[weight=0][.][bench]") {
+
+  const PuzzleState puzzle_goal({1,2,3,4,5,6,7,8,9});
+  const PuzzleState puzzle_start({8,6,7,2,5,4,3,9,1});
+
+  auto startTime = std::chrono::steady_clock::now();
+  std::list<PuzzleState> path = puzzleBFS(puzzle_start, puzzle_goal);
+  auto bfsMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+  PuzzleSearchStats aStarStats;
+  startTime = std::chrono::steady_clock::now();
+  std::list<PuzzleState> aStarPath = puzzleAStar(puzzle_start, puzzle_goal, &aStarStats);
+  auto aStarMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+  PuzzleSearchStats idaStarStats;
+  startTime = std::chrono::steady_clock::now();
+  std::list<PuzzleState> idaStarPath = puzzleIDAStar(puzzle_start, puzzle_goal, &idaStarStats);
+  auto idaStarMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+  std::cout << "Hardest 8 puzzle: puzzleBFS " << bfsMs << " ms, A* " << aStarMs << " ms ("
+    << aStarStats.expandedCount << " expanded), IDA* " << idaStarMs << " ms ("
+    << idaStarStats.expandedCount << " expanded)" << std::endl;
+  REQUIRE(aStarPath.size() == path.size());
+  REQUIRE(idaStarPath.size() == path.size());
+
+  srand(15);
+  const PuzzleTiles<4> goal15 = {1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16};
+  const PuzzleTiles<4> start15 = scramble15Puzzle(60);
+  startTime = std::chrono::steady_clock::now();
+  std::vector<PuzzleTiles<4>> solution15 = idaStarSolve<4>(start15, goal15, &idaStarStats);
+  idaStarMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+  std::cout << "15 puzzle (" << solution15.size() - 1 << " moves): IDA* " << idaStarMs << " ms ("
+    << idaStarStats.expandedCount << " expanded)" << std::endl;
+  REQUIRE(isTilesPath<4>(solution15));
+}
+
+// ========================================================================
+// Tests: PackedPuzzleState
+// ========================================================================
+
+TEST_CASE("PackedPuzzleState packs and ranks puzzle states:", "[weight=0]") {
+
+  SECTION("Should fit in 64 bits and convert back") {
+    REQUIRE(sizeof(PackedPuzzleState) == 8);
+    const PuzzleState state({9,2,6,1,3,5,4,7,8});
+    const PackedPuzzleState packed(state);
+    REQUIRE(packed.toPuzzleState() == state);
+    REQUIRE(packed.getBlankIndex() == 0);
+    REQUIRE(packed.tileAt(2) == 6);
+    REQUIRE(PackedPuzzleState::fromBits(packed.getBits()) == packed);
+    REQUIRE_THROWS_AS(PackedPuzzleState({1,1,3,4,5,6,7,8,9}), std::runtime_error);
+  }
+
+  SECTION("Should give every state a different rank") {
+    REQUIRE(PackedPuzzleState().rank() == 0);
+    REQUIRE(PackedPuzzleState({9,8,7,6,5,4,3,2,1}).rank() == PackedPuzzleState::RANK_COUNT - 1);
+    REQUIRE(PackedPuzzleState({1,2,3,4,5,6,7,9,8}).rank() == 1);
+    for (std::uint32_t rank = 0; rank < PackedPuzzleState::RANK_COUNT; rank++) {
+      if (PackedPuzzleState::unrank(rank).rank() != rank) {
+        FAIL("unrank and rank disagree for rank " << rank);
+      }
+    }
+    REQUIRE_THROWS_AS(PackedPuzzleState::unrank(PackedPuzzleState::RANK_COUNT), std::runtime_error);
+  }
+
+  SECTION("Should find the same adjacent states as PuzzleState") {
+    srand(450);
+    for (int i=0; i<50; i++) {
+      const PuzzleState state = PuzzleState::randomizePuzzle(PuzzleState(), 20);
+      const std::vector<PuzzleState> expected = state.getAdjacentStates();
+      PackedPuzzleState adjacent[4];
+      const int count = PackedPuzzleState(state).getAdjacentStates(adjacent);
+      REQUIRE(count == static_cast<int>(expected.size()));
+      for (int j=0; j<count; j++) {
+        REQUIRE(adjacent[j].toPuzzleState() == expected[j]);
+      }
+    }
+  }
+
+}
+
+TEST_CASE("puzzleRankBFS finds the same solution lengths as puzzleBFS:", "[weight=0]") {
+
+  srand(451);
+  const PuzzleState puzzle_goal({1,2,3,4,5,6,7,8,9});
+  for (int i=0; i<5; i++) {
+    const PuzzleState puzzle_start = PuzzleState::randomizePuzzle(puzzle_goal, 20);
+    std::list<PuzzleState> path = puzzleBFS(puzzle_start, puzzle_goal);
+    std::list<PuzzleState> rankPath = puzzleRankBFS(puzzle_start, puzzle_goal);
+    REQUIRE(rankPath.size() == path.size());
+    REQUIRE(isPuzzlePath(rankPath, puzzle_start, puzzle_goal));
+  }
+
+  REQUIRE(puzzleRankBFS(puzzle_goal, puzzle_goal) == std::list<PuzzleState>{puzzle_goal});
+  REQUIRE(puzzleRankBFS(PuzzleState({1,3,2,4,5,6,7,8,9}), puzzle_goal).empty());
+}
+
+// This is hidden because of the [.] tag. You can run it explicitly with: ./test [bench]
+TEST_CASE("Benchmark: puzzleBFS vs. puzzleRankBFS", "[weight=0][.][bench]") {
+
+  const PuzzleState puzzle_goal({1,2,3,4,5,6,7,8,9});
+  // One of the hardest 8 puzzles (31 moves), and one that can't be solved.
+  const std::vector<PuzzleState> starts = {PuzzleState({8,6,7,2,5,4,3,9,1}), PuzzleState({1,3,2,4,5,6,7,8,9})};
+
+  for (const PuzzleState& puzzle_start : starts) {
+    auto startTime = std::chrono::steady_clock::now();
+    std::list<PuzzleState> path = puzzleBFS(puzzle_start, puzzle_goal);
+    auto bfsMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    startTime = std::chrono::steady_clock::now();
+    std::list<PuzzleState> rankPath = puzzleRankBFS(puzzle_start, puzzle_goal);
+    auto rankMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::cout << puzzle_start.stringify() << ": puzzleBFS " << bfsMs << " ms, puzzleRankBFS " << rankMs << " ms" << std::endl;
+    REQUIRE(rankPath.size() == path.size());
+  }
+
+  // Memory per visited state. puzzleBFS stores each state in pred (twice),
+  // dist, visitedSet and dequeuedSet, each in a hash table node with a next
+  // pointer and a saved hash, plus about one bucket pointer per table.
+  const std::size_t nodeOverhead = sizeof(void*) + sizeof(std::size_t);
+  const std::size_t bfsBytes = 4 * sizeof(void*)
+    + nodeOverhead + sizeof(std::pair<const PuzzleState, PuzzleState>)
+    + nodeOverhead + sizeof(std::pair<const PuzzleState, int>)
+    + 2 * (nodeOverhead + sizeof(PuzzleState));
+  // puzzleRankBFS has one pred entry for each of the 9! ranks, but only
+  // half of them can be reached, plus one queue entry per visited state.
+  const std::size_t rankBytes = 2 * sizeof(std::uint32_t) + sizeof(PackedPuzzleState);
+  std::cout << "Memory per visited state: puzzleBFS about " << bfsBytes << " bytes, puzzleRankBFS about "
+    << rankBytes << " bytes" << std::endl;
+}
@@ -9,7 +9,7 @@ ZIP_FILE = graph_search_submission.zip
 COLLECTED_FILES = GraphSearchExercises.cpp
 
 # Add standard object files (HSLAPixel, PNG, and LodePNG)
-OBJS += GraphSearchExercises.o PuzzleState.o GridGraph.o
+OBJS += GraphSearchExercises.o PuzzleState.o GridGraph.o DenseGridGraph.o GridBFS.o BidirectionalBFS.o PuzzleSolvers.o PackedPuzzleState.o
 
 # Use ./.objs to store all .o file (keeping the directory clean)
 OBJS_DIR = .objs